@@ -1,4 +1,8 @@
-#version 330 core
+#version 300 es
+precision highp float;
+precision highp int;
+precision highp sampler2D;
+precision highp usampler2D;
 
 struct Material {
     // Basic properties
@@ -38,45 +42,42 @@ struct Material {
 in vec2 TexCoords;
 uniform Material material;
 
-// Lighting structures (same as before)
+// Lighting structures, laid out in vec4s to match the std140 LightData block
 struct DirectionLight{
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+    vec4 direction;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
 };
-uniform DirectionLight dirLight;
 
-struct PointLight{
-    vec3 position;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float constant;
-    float linear;
-    float quadratic;   
+#define POINT_LIGHT 0.0
+#define SPOT_LIGHT 1.0
+
+layout (std140) uniform LightData {
+    DirectionLight dirLight;
+    vec4 clusterScale; // xy = clusters per pixel, z = slices per log depth, w = slice offset
+    ivec4 clusterDims; // xyz = cluster grid size, w = clustered light count
 };
-#define NR_POINT_LIGHTS 4
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-
-struct Spotlight{
-    vec3 position;  
-    vec3 direction;
-    float cutOff;
-    float outerCutOff;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    float constant;
-    float linear;
-    float quadratic;
+
+// Clustered point and spot lights, see ClusteredLighting.hpp
+uniform sampler2D clusterLightData;     // 6 texels per light, 64 lights per row
+uniform usampler2D clusterGrid;         // (offset, count) per cluster, x + y * gridX across, slice down
+uniform usampler2D clusterLightIndices; // Flattened per cluster light lists, 1024 per row
+
+#define LIGHT_INDEX_WIDTH 1024u
+#define LIGHT_TEXELS 6
+#define LIGHTS_PER_ROW 64
+
+layout (std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
 };
-uniform Spotlight spotLight;
 
 out vec4 FragColor;
 in vec3 Normal;
 in vec3 FragPos;
-uniform vec3 cameraPos;
 
 // Helper function to get material diffuse color
 vec3 getMaterialDiffuse() {
@@ -122,7 +123,7 @@ vec3 getNormalFromMap() {
 
 vec3 calculateDirectionLight(DirectionLight light, vec3 normal, vec3 view_direction)
 {
-    vec3 light_direction = normalize(-light.direction);
+    vec3 light_direction = normalize(-light.direction.xyz);
     
     // Diffuse shading
     float diff = max(dot(normal, light_direction), 0.0);
@@ -131,83 +132,76 @@ vec3 calculateDirectionLight(DirectionLight light, vec3 normal, vec3 view_direct
     vec3 reflect_direction = reflect(-light_direction, normal);
     float spec = pow(max(dot(view_direction, reflect_direction), 0.0), material.shininess);
     
-    vec3 ambient  = light.ambient  * getMaterialAmbient();
-    vec3 diffuse  = light.diffuse  * diff * getMaterialDiffuse();
-    vec3 specular = light.specular * spec * getMaterialSpecular();
+    vec3 ambient  = light.ambient.rgb  * getMaterialAmbient();
+    vec3 diffuse  = light.diffuse.rgb  * diff * getMaterialDiffuse();
+    vec3 specular = light.specular.rgb * spec * getMaterialSpecular();
     
     return (ambient + diffuse + specular);
 }
 
-vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 view_direction)
+vec4 fetchLightTexel(int index, int texel)
 {
-    vec3 lightDir = normalize(light.position - fragPos);
-    
-    // Diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    
-    // Specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(view_direction, reflectDir), 0.0), material.shininess);
-    
-    // Attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
-    
-    // Combine results
-    vec3 ambient  = light.ambient  * getMaterialAmbient();
-    vec3 diffuse  = light.diffuse  * diff * getMaterialDiffuse();
-    vec3 specular = light.specular * spec * getMaterialSpecular();
-    
-    ambient  *= attenuation;
-    diffuse  *= attenuation;
-    specular *= attenuation;
-    
-    return (ambient + diffuse + specular);
+    return texelFetch(clusterLightData, ivec2((index % LIGHTS_PER_ROW) * LIGHT_TEXELS + texel, index / LIGHTS_PER_ROW), 0);
 }
 
-vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 view_direction)
+vec3 calculateClusteredLight(int index, vec3 normal, vec3 fragPos, vec3 view_direction)
 {
-    vec3 light_direction = normalize(light.position - fragPos);
+    vec4 positionRange = fetchLightTexel(index, 0);
+    vec4 lightAmbient  = fetchLightTexel(index, 1);
+    vec4 lightDiffuse  = fetchLightTexel(index, 2);
+    vec4 lightSpecular = fetchLightTexel(index, 3);
+    vec4 attenuation   = fetchLightTexel(index, 4); // w = spot outerCutOff
+    
+    vec3 toLight = positionRange.xyz - fragPos;
+    float distance = length(toLight);
+    vec3 light_direction = toLight / max(distance, 0.0001);
     
-    // Diffuse
+    // Diffuse shading
     float diff = max(dot(normal, light_direction), 0.0);
     
-    // Specular
+    // Specular shading
     vec3 reflect_direction = reflect(-light_direction, normal);
     float spec = pow(max(dot(view_direction, reflect_direction), 0.0), material.shininess);
     
-    // Attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
-    
-    // Spotlight intensity
-    float theta = dot(light_direction, normalize(-light.direction));
-    float epsilon = light.cutOff - light.outerCutOff;
-    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
-    
-    vec3 ambient = light.ambient * getMaterialAmbient();
-    vec3 diffuse = light.diffuse * diff * getMaterialDiffuse();
-    vec3 specular = light.specular * spec * getMaterialSpecular();
+    // Attenuation, faded to zero at the range the light was binned with so cluster edges don't show
+    float falloff = 1.0 / (attenuation.x + attenuation.y * distance + attenuation.z * (distance * distance));
+    float window = clamp(1.0 - pow(distance / positionRange.w, 4.0), 0.0, 1.0);
+    falloff *= window * window;
+    
+    // Spotlight cone
+    if (lightAmbient.w == SPOT_LIGHT) {
+        vec4 direction = fetchLightTexel(index, 5); // w = cutOff
+        float theta = dot(light_direction, normalize(-direction.xyz));
+        float epsilon = direction.w - attenuation.w;
+        falloff *= clamp((theta - attenuation.w) / epsilon, 0.0, 1.0);
+    }
     
-    ambient *= attenuation * intensity;
-    diffuse *= attenuation * intensity;
-    specular *= attenuation * intensity;
+    vec3 ambient  = lightAmbient.rgb  * getMaterialAmbient();
+    vec3 diffuse  = lightDiffuse.rgb  * diff * getMaterialDiffuse();
+    vec3 specular = lightSpecular.rgb * spec * getMaterialSpecular();
     
-    return (ambient + diffuse + specular);
+    return (ambient + diffuse + specular) * falloff;
 }
 
 void main()
 {
     vec3 norm = getNormalFromMap();
-    vec3 viewDir = normalize(cameraPos - FragPos);
+    vec3 viewDir = normalize(cameraPosition.xyz - FragPos);
     
     // Calculate lighting
     vec3 result = calculateDirectionLight(dirLight, norm, viewDir);
     
-    for(int i = 0; i < NR_POINT_LIGHTS; i++)
-        result += calculatePointLight(pointLights[i], norm, FragPos, viewDir);    
+    // Only the lights binned into this fragment's cluster
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    int slice = clamp(int(log(max(viewDepth, 0.0001)) * clusterScale.z + clusterScale.w), 0, clusterDims.z - 1);
+    ivec2 tile = min(ivec2(gl_FragCoord.xy * clusterScale.xy), clusterDims.xy - 1);
+    uvec2 cluster = texelFetch(clusterGrid, ivec2(tile.x + tile.y * clusterDims.x, slice), 0).rg;
     
-    result += calculateSpotlight(spotLight, norm, FragPos, viewDir);    
+    for(uint i = 0u; i < cluster.y; i++) {
+        uint listIndex = cluster.x + i;
+        uint lightIndex = texelFetch(clusterLightIndices, ivec2(int(listIndex % LIGHT_INDEX_WIDTH), int(listIndex / LIGHT_INDEX_WIDTH)), 0).r;
+        result += calculateClusteredLight(int(lightIndex), norm, FragPos, viewDir);
+    }
     
     // Add emissive component
     if (material.hasEmissiveMap) {
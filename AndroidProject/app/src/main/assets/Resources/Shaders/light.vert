@@ -1,11 +1,21 @@
-#version 330 core
+#version 300 es
+precision highp float;
 layout (location = 0) in vec3 aPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Maps the quantized position back to model space
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+layout (std140) uniform CameraData {
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	vec4 cameraPosition;
+};
 
 void main()
 {
-	gl_Position = projection * view * model * vec4(aPos, 1.0);
+	gl_Position = viewProjection * model * vec4(positionOffset + aPos * positionScale, 1.0);
 }
\ No newline at end of file
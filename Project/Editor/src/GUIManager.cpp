@@ -67,6 +67,9 @@ void GUIManager::Initialize() {
 void GUIManager::Render() {
 	assert(panelManager != nullptr && "PanelManager must be initialized before rendering");
 	
+	// Panels add their scene views as they are built
+	SceneRenderer::BeginFrame();
+
 	// Start ImGui frame
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
@@ -95,6 +98,9 @@ void GUIManager::Render() {
 		glfwMakeContextCurrent(backup_current_context);
 	}
 
+	// Draw the scene views the panels are about to show
+	SceneRenderer::ExecuteFrame();
+
 	// Render ImGui on top of the scene
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -108,7 +114,7 @@ void GUIManager::Render() {
 
 void GUIManager::Exit() {
 	// SceneRenderer handles framebuffer cleanup
-	SceneRenderer::DeleteSceneFramebuffer();
+	SceneRenderer::Shutdown();
 	
 	// Clean up panel manager
 	panelManager.reset();
@@ -40,10 +40,6 @@ void GamePanel::OnImGuiRender() {
         if (availableWidth < 100) availableWidth = 100;
         if (availableHeight < 100) availableHeight = 100;
 
-        // Always render at a fixed base resolution (e.g., 1920x1080 for 16:9)
-        const int baseRenderWidth = 1920;
-        const int baseRenderHeight = 1080;
-
         // Calculate display viewport dimensions with aspect ratio preservation
         int displayWidth, displayHeight;
         float offsetX, offsetY;
@@ -56,55 +52,22 @@ void GamePanel::OnImGuiRender() {
         ImVec2 startPos = ImGui::GetCursorPos();
         ImGui::SetCursorPos(ImVec2(startPos.x + offsetX, startPos.y + offsetY));
 
-        // Always render the scene at base resolution (no stretching)
-        SceneRenderer::BeginSceneRender(baseRenderWidth, baseRenderHeight);
-
-        if (Engine::ShouldRunGameLogic() || Engine::IsPaused()) {
-            // Render 3D scene with game logic running
-            SceneRenderer::RenderScene(); // This will run with game logic
-        } else {
-            // Render scene preview with game camera (no game logic)
-            SceneRenderer::RenderScene(); // This should show the game camera view
-        }
-
-        SceneRenderer::EndSceneRender();
+        // Render at the size shown, already in the target aspect ratio, so nothing needs cropping.
+        // The pass runs with the game camera (and game logic when playing) before the UI is drawn
+        SceneRenderer::AddGameViewPass(displayWidth, displayHeight);
 
         // Get the texture from SceneRenderer and display it
-        unsigned int sceneTexture = SceneRenderer::GetSceneTexture();
+        unsigned int sceneTexture = SceneRenderer::GetViewTexture(SceneRenderer::View::Game);
         if (sceneTexture != 0) {
-            // Calculate crop UV coordinates based on target aspect ratio
-            float targetAspectRatio;
-            if (freeAspect) {
-                targetAspectRatio = (float)displayWidth / (float)displayHeight;
-            } else if (useCustomAspectRatio) {
-                targetAspectRatio = customAspectRatio;
-            } else {
-                const auto& res = resolutions[selectedResolutionIndex];
-                targetAspectRatio = (float)res.width / (float)res.height;
-            }
-
-            float baseAspectRatio = (float)baseRenderWidth / (float)baseRenderHeight;
-
-            // Calculate UV coordinates for cropping
-            ImVec2 uv0, uv1;
-            if (targetAspectRatio > baseAspectRatio) {
-                // Target is wider - crop top/bottom
-                float cropHeight = baseAspectRatio / targetAspectRatio;
-                float cropOffset = (1.0f - cropHeight) * 0.5f;
-                uv0 = ImVec2(0, 1.0f - cropOffset);        // Bottom-left
-                uv1 = ImVec2(1, cropOffset);               // Top-right
-            } else {
-                // Target is taller - crop left/right
-                float cropWidth = targetAspectRatio / baseAspectRatio;
-                float cropOffset = (1.0f - cropWidth) * 0.5f;
-                uv0 = ImVec2(cropOffset, 1);               // Bottom-left
-                uv1 = ImVec2(1.0f - cropOffset, 0);        // Top-right
-            }
+            // The view covers the bottom left of the pooled texture, flipped for OpenGL
+            glm::vec2 uvScale = SceneRenderer::GetViewUVScale(SceneRenderer::View::Game);
+            ImVec2 uv0 = ImVec2(0, uvScale.y);            // Bottom-left
+            ImVec2 uv1 = ImVec2(uvScale.x, 0);            // Top-right
 
             ImGui::Image(
                 (void*)(intptr_t)sceneTexture,
                 ImVec2((float)displayWidth, (float)displayHeight),
-                uv0, uv1  // Use calculated crop coordinates
+                uv0, uv1
             );
 
             // Draw border around viewport for clarity
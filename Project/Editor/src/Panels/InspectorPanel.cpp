@@ -173,6 +173,9 @@ void InspectorPanel::DrawModelRenderComponent(Entity entity) {
             ImGui::Text("Shader: None");
         }
 
+        // Static entities are merged into batched world space meshes, moving one rebuilds the batches
+        ImGui::Checkbox("Static", &modelRenderer.isStatic);
+
         ImGui::PopID();
     } catch (const std::exception& e) {
         ImGui::Text("Error accessing ModelRenderComponent: %s", e.what());
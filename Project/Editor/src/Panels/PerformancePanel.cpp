@@ -1,6 +1,30 @@
 #include "Panels/PerformancePanel.hpp"
 #include "imgui.h"
 #include "WindowManager.hpp"
+#include "Graphics/DynamicResolution.hpp"
+#include "Graphics/RenderStats.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/GeometryArena.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+    // One counter across the history, with the last frame's value in the label
+    void PlotCounter(const char* label, const std::vector<RenderStats::Counters>& history, const std::function<float(const RenderStats::Counters&)>& value) {
+        std::vector<float> values;
+        values.reserve(history.size());
+        float maxValue = 1.0f;
+        for (const RenderStats::Counters& frame : history) {
+            values.push_back(value(frame));
+            maxValue = std::max(maxValue, values.back());
+        }
+
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%.0f", values.empty() ? 0.0f : values.back());
+        ImGui::PlotLines(label, values.data(), static_cast<int>(values.size()), 0, overlay, 0.0f, maxValue * 1.1f, ImVec2(0.0f, 40.0f));
+    }
+}
 
 PerformancePanel::PerformancePanel()
     : EditorPanel("Performance", true) {
@@ -10,6 +34,55 @@ void PerformancePanel::OnImGuiRender() {
     if (ImGui::Begin(name.c_str(), &isOpen)) {
         ImGui::Text("FPS: %.1f", WindowManager::getFps());
         ImGui::Text("Delta Time: %.3f ms", WindowManager::getDeltaTime() * 1000.0);
+
+        if (ImGui::CollapsingHeader("Dynamic Resolution", ImGuiTreeNodeFlags_DefaultOpen)) {
+            DynamicResolution& dynamicResolution = DynamicResolution::GetInstance();
+            DynamicResolution::Settings& settings = dynamicResolution.GetSettings();
+
+            ImGui::Checkbox("Enabled", &settings.enabled);
+            ImGui::SliderFloat("Target FPS", &settings.targetFps, 30.0f, 144.0f, "%.0f");
+            ImGui::SliderFloat("Min Scale", &settings.minScale, DynamicResolution::SCALE_STEP, 1.0f, "%.2f");
+            ImGui::SliderFloat("Max Scale", &settings.maxScale, settings.minScale, 1.0f, "%.2f");
+
+            ImGui::Text("Render Scale: %.0f%%", dynamicResolution.GetScale() * 100.0f);
+            ImGui::Text("CPU Frame: %.2f ms", dynamicResolution.GetCpuFrameMs());
+            if (dynamicResolution.HasGpuTimings()) {
+                ImGui::Text("GPU Game View: %.2f ms", dynamicResolution.GetGpuFrameMs());
+            } else {
+                ImGui::Text("GPU Game View: N/A");
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Render Stats", ImGuiTreeNodeFlags_DefaultOpen)) {
+#if RENDER_STATS_ENABLED
+            const std::vector<RenderStats::Counters> history = RenderStats::GetInstance().GetHistory();
+            const RenderStats::Counters last = history.empty() ? RenderStats::Counters{} : history.back();
+
+            ImGui::Text("Draw Calls: %u (%u instanced)", last.drawCalls, last.instancedDrawCalls);
+            ImGui::Text("Triangles: %llu", static_cast<unsigned long long>(last.triangles));
+            ImGui::Text("Objects: %u visible, %u culled", last.visibleObjects, last.culledObjects);
+            ImGui::Text("Program Binds: %u  Texture Binds: %u", last.programBinds, last.textureBinds);
+            ImGui::Text("Uniform Uploads: %u", last.uniformUploads);
+            ImGui::Text("Buffer Uploads: %.1f KB", last.bufferUploadBytes / 1024.0);
+            ImGui::Text("Glyphs: %u", last.glyphs);
+
+            const GLStateCache::Stats& stateStats = GLStateCache::GetInstance().GetLastFrameStats();
+            ImGui::Text("GL State Changes: %u issued, %u skipped", stateStats.issued, stateStats.skipped);
+
+            const GeometryArena::Stats arenaStats = GeometryArena::GetInstance().GetStats();
+            ImGui::Text("Geometry Arena: %.1f / %.1f MB in %zu pages", arenaStats.usedBytes / (1024.0 * 1024.0), arenaStats.reservedBytes / (1024.0 * 1024.0), arenaStats.pageCount);
+
+            ImGui::Separator();
+            PlotCounter("Draw Calls", history, [](const RenderStats::Counters& frame) { return static_cast<float>(frame.drawCalls); });
+            PlotCounter("Triangles", history, [](const RenderStats::Counters& frame) { return static_cast<float>(frame.triangles); });
+            PlotCounter("Visible", history, [](const RenderStats::Counters& frame) { return static_cast<float>(frame.visibleObjects); });
+            PlotCounter("State Binds", history, [](const RenderStats::Counters& frame) { return static_cast<float>(frame.programBinds + frame.textureBinds); });
+            PlotCounter("Uniforms", history, [](const RenderStats::Counters& frame) { return static_cast<float>(frame.uniformUploads); });
+            PlotCounter("Upload KB", history, [](const RenderStats::Counters& frame) { return static_cast<float>(frame.bufferUploadBytes / 1024.0); });
+#else
+            ImGui::TextDisabled("Compiled out, build with RENDER_STATS_ENABLED=1 to count");
+#endif
+        }
     }
     ImGui::End();
-}
\ No newline at end of file
+}
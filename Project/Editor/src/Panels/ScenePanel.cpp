@@ -238,7 +238,8 @@ void ScenePanel::OnImGuiRender() {
         ImVec2 imagePos = ImGui::GetCursorScreenPos();
 
         // Get the texture from SceneRenderer and display it
-        unsigned int sceneTexture = SceneRenderer::GetSceneTexture();
+        unsigned int sceneTexture = SceneRenderer::GetViewTexture(SceneRenderer::View::Editor);
+        glm::vec2 uvScale = SceneRenderer::GetViewUVScale(SceneRenderer::View::Editor);
         if (sceneTexture != 0) {
             // Use a child window to contain both the image and ImGuizmo
             ImGui::BeginChild("SceneView", ImVec2((float)sceneViewWidth, (float)sceneViewHeight), false,
@@ -253,7 +254,7 @@ void ScenePanel::OnImGuiRender() {
             drawList->AddImage(
                 (void*)(intptr_t)sceneTexture,
                 childPos, ImVec2(childPos.x + childSize.x, childPos.y + childSize.y),
-                ImVec2(0, 1), ImVec2(1, 0)  // Flip Y coordinate for OpenGL
+                ImVec2(0, uvScale.y), ImVec2(uvScale.x, 0)  // Flip Y coordinate for OpenGL
             );
 
             // Check if the child window is hovered (without invisible button interfering)
@@ -286,15 +287,14 @@ void ScenePanel::OnImGuiRender() {
 
 void ScenePanel::RenderSceneWithEditorCamera(int width, int height) {
     try {
-        // Pass our editor camera data to the rendering system
-        SceneRenderer::BeginSceneRender(width, height);
-        SceneRenderer::RenderSceneForEditor(
+        // Pass our editor camera data to the rendering system, drawn before the UI renders
+        SceneRenderer::AddEditorViewPass(
+            width, height,
             editorCamera.Position,
             editorCamera.Front,
             editorCamera.Up,
             editorCamera.Zoom
         );
-        SceneRenderer::EndSceneRender();
 
         // Now both the visual representation AND ImGuizmo overlay use our editor camera
         // This gives us proper Unity-style editor controls
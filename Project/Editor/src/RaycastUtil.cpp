@@ -85,49 +85,18 @@ RaycastUtil::RaycastHit RaycastUtil::RaycastScene(const Ray& ray) {
         ECSRegistry& registry = ECSRegistry::GetInstance();
         ECSManager& ecsManager = registry.GetActiveECSManager();
 
-        std::cout << "[RaycastUtil] Ray origin: (" << ray.origin.x << ", " << ray.origin.y << ", " << ray.origin.z
-                  << ") direction: (" << ray.direction.x << ", " << ray.direction.y << ", " << ray.direction.z << ")" << std::endl;
-
-        int entitiesWithComponent = 0;
-
-        // Test against entities 0-50, looking for Transform components
-        for (Entity entity = 0; entity <= 50; ++entity) {
-            // Check if entity has Transform component
-            if (!ecsManager.HasComponent<Transform>(entity)) {
-                continue;  // Skip if entity has no transform
-            }
-
-            try {
-                auto& transform = ecsManager.GetComponent<Transform>(entity);
-
-                entitiesWithComponent++;
-                std::cout << "[RaycastUtil] Found entity " << entity << " with Transform component" << std::endl;
-
-                // Create AABB from the entity's transform
-                AABB entityAABB = CreateAABBFromTransform(transform.model);
-
-                std::cout << "[RaycastUtil] Entity " << entity << " AABB: min("
-                          << entityAABB.min.x << ", " << entityAABB.min.y << ", " << entityAABB.min.z
-                          << ") max(" << entityAABB.max.x << ", " << entityAABB.max.y << ", " << entityAABB.max.z << ")" << std::endl;
-
-                // Test ray intersection
-                float distance;
-                if (RayAABBIntersection(ray, entityAABB, distance)) {
-                    // Check if this is the closest hit
-                    if (!closestHit.hit || distance < closestHit.distance) {
-                        closestHit.hit = true;
-                        closestHit.entity = entity;
-                        closestHit.distance = distance;
-                        closestHit.point = ray.origin + ray.direction * distance;
-                    }
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "[RaycastUtil] Error processing entity " << entity << ": " << e.what() << std::endl;
-                continue;
-            }
+        if (!ecsManager.spatialIndexSystem) {
+            return closestHit;
         }
 
-        std::cout << "[RaycastUtil] Tested " << entitiesWithComponent << " entities with Transform components" << std::endl;
+        // Walk the engine's spatial index, models are tested against their triangles
+        SpatialRaycastHit hit;
+        if (ecsManager.spatialIndexSystem->Raycast(ray.origin, ray.direction, std::numeric_limits<float>::max(), hit)) {
+            closestHit.hit = true;
+            closestHit.entity = hit.entity;
+            closestHit.distance = hit.distance;
+            closestHit.point = hit.point;
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "[RaycastUtil] Error during raycast: " << e.what() << std::endl;
@@ -8,6 +8,7 @@
 #include "SystemManager.hpp"
 #include <Transform/TransformSystem.hpp>
 #include <Graphics/Model/ModelSystem.hpp>
+#include <Graphics/SpatialIndexSystem.hpp>
 #include <Graphics/TextRendering/TextRenderingSystem.hpp>
 #include "../Engine.h"  // For ENGINE_API macro
 
@@ -90,6 +91,7 @@ public:
 	// e.g., 
 	std::shared_ptr<TransformSystem> transformSystem;
 	std::shared_ptr<ModelSystem> modelSystem;
+	std::shared_ptr<SpatialIndexSystem> spatialIndexSystem;
 	std::shared_ptr<TextRenderingSystem> textSystem;
 
 private:
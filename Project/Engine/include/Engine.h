@@ -51,6 +51,11 @@ public:
     static bool IsPlayMode();
     static bool IsPaused();
 
+    // Draw on a dedicated render thread that owns the GL context. Set before Initialize().
+    // Game builds only, the editor UI still draws from the main thread
+    static void SetThreadedRendering(bool enabled);
+
 private:
     static GameState currentGameState;
+    static bool threadedRendering;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <glm/glm.hpp>
+
+// Axis-aligned bounding box. A default constructed box is empty (min > max) until something is added.
+struct AABB {
+	glm::vec3 min{ FLT_MAX };
+	glm::vec3 max{ -FLT_MAX };
+
+	AABB() = default;
+	AABB(const glm::vec3& minimum, const glm::vec3& maximum) : min(minimum), max(maximum) {}
+
+	bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+	glm::vec3 Center() const { return (min + max) * 0.5f; }
+	glm::vec3 Extents() const { return (max - min) * 0.5f; }
+
+	void Expand(const glm::vec3& point)
+	{
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+
+	void Expand(const AABB& other)
+	{
+		if (!other.IsValid()) return;
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	}
+
+	// Box that encloses this box after transformation (Arvo's method)
+	AABB Transformed(const glm::mat4& transform) const
+	{
+		if (!IsValid()) return *this;
+
+		glm::vec3 center = glm::vec3(transform * glm::vec4(Center(), 1.0f));
+		glm::vec3 extents = Extents();
+		glm::vec3 newExtents(0.0f);
+		for (int row = 0; row < 3; row++)
+		{
+			newExtents[row] = std::abs(transform[0][row]) * extents.x
+				+ std::abs(transform[1][row]) * extents.y
+				+ std::abs(transform[2][row]) * extents.z;
+		}
+		return AABB(center - newExtents, center + newExtents);
+	}
+};
+
+struct BoundingSphere {
+	glm::vec3 center{ 0.0f };
+	float radius = 0.0f;
+
+	BoundingSphere() = default;
+	BoundingSphere(const glm::vec3& c, float r) : center(c), radius(r) {}
+
+	// Sphere after transformation. Non-uniform scale grows the radius by the largest axis scale
+	BoundingSphere Transformed(const glm::mat4& transform) const
+	{
+		glm::vec3 newCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+		float scaleX = glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0]));
+		float scaleY = glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1]));
+		float scaleZ = glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]));
+		float maxScale = std::sqrt(std::max(scaleX, std::max(scaleY, scaleZ)));
+		return BoundingSphere(newCenter, radius * maxScale);
+	}
+};
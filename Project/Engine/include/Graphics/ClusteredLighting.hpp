@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "OpenGL.h"
+
+struct LightSet;
+struct FrameView;
+
+// Texture units the light lists stay bound to, kept clear of the material maps
+namespace ClusterTextureUnit {
+	constexpr GLuint LIGHT_DATA = 13;
+	constexpr GLuint CLUSTER_GRID = 14;
+	constexpr GLuint LIGHT_INDICES = 15;
+}
+
+// One light as read by the shader, LIGHT_TEXELS consecutive RGBA32F texels in the light texture
+struct ClusterLight {
+	glm::vec4 positionRange;    // xyz = world position, w = distance past which it is culled
+	glm::vec4 ambient;          // w = type, 0 = point, 1 = spot
+	glm::vec4 diffuse;
+	glm::vec4 specular;
+	glm::vec4 attenuation;      // x = constant, y = linear, z = quadratic, w = spot outerCutOff
+	glm::vec4 direction;        // xyz = spot direction, w = spot cutOff
+};
+
+/**
+ * @brief Bins point and spot lights into a view space froxel grid so each fragment only shades
+ * the lights that can reach it.
+ *
+ * The view is split into GRID_X x GRID_Y screen tiles and GRID_Z depth slices spaced
+ * exponentially between the near and far planes. Every view, each light's bounding sphere
+ * (sized from its attenuation) is tested against the clusters it could overlap, and the
+ * results are uploaded as three textures: the light records, a per-cluster (offset, count)
+ * grid and the flattened index lists. GLES 3.0 has no storage buffers, so plain 2D textures
+ * read with texelFetch stand in for them.
+ */
+class ClusteredLighting {
+public:
+	static constexpr int GRID_X = 16;
+	static constexpr int GRID_Y = 9;
+	static constexpr int GRID_Z = 24;
+	static constexpr int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+	static constexpr int LIGHT_TEXELS = sizeof(ClusterLight) / sizeof(glm::vec4);
+	static constexpr uint32_t MAX_LIGHTS = 4096;
+	// Lights wrap into rows so the texture stays within GLES 3.0's guaranteed 2048 texel size
+	static constexpr uint32_t LIGHTS_PER_ROW = 64;
+	static constexpr int INDEX_TEXTURE_WIDTH = 1024;
+	static constexpr uint32_t MAX_LIGHT_INDICES = INDEX_TEXTURE_WIDTH * 1024;
+
+	// Lights are culled once they fall below this fraction of their brightest channel's output
+	static constexpr float INTENSITY_CUTOFF = 1.0f / 256.0f;
+
+	static ClusteredLighting& GetInstance();
+
+	void Shutdown();
+
+	// Rebuilds the cluster lists for this view, uploads them and binds them to their texture units
+	void Update(const LightSet& lightSet, const FrameView& frameView);
+
+	// Depth slice of a view space distance is floor(log(distance) * x + y)
+	static glm::vec2 GetSliceScale(const FrameView& frameView);
+
+	// Points the program's cluster samplers at their texture units, call after linking
+	static void BindShaderSamplers(GLuint program);
+
+	uint32_t GetLightCount() const { return static_cast<uint32_t>(lights.size()); }
+	uint32_t GetIndexCount() const { return static_cast<uint32_t>(lightIndices.size()); }
+
+private:
+	ClusteredLighting() = default;
+	~ClusteredLighting() = default;
+
+	ClusteredLighting(const ClusteredLighting&) = delete;
+	ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+	struct ClusterBounds {
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	void GatherLights(const LightSet& lightSet, const FrameView& frameView);
+	void BuildClusterBounds(const FrameView& frameView);
+	void AssignLights(const FrameView& frameView);
+	void UploadTextures();
+
+	static float ComputeRange(const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, float constant, float linear, float quadratic, float maxRange);
+
+	std::vector<ClusterLight> lights;
+	std::vector<glm::vec4> viewSpheres;         // xyz = view space center, w = radius, per light
+	std::vector<ClusterBounds> clusterBounds;   // View space AABB per cluster
+	glm::mat4 boundsProjection{ 0.0f };         // Projection the bounds were built for
+
+	std::vector<uint32_t> clusterCounts;
+	std::vector<uint32_t> clusterGrid;          // (offset, count) pairs
+	std::vector<uint32_t> lightIndices;
+	std::vector<uint32_t> pairs;                // Cluster << 16 | light, before sorting into lists
+	bool reportedOverflow = false;
+
+	GLuint lightTexture = 0;
+	GLuint gridTexture = 0;
+	GLuint indexTexture = 0;
+};
+
+static_assert(ClusteredLighting::LIGHT_TEXELS * ClusteredLighting::LIGHTS_PER_ROW <= 2048
+	&& ClusteredLighting::MAX_LIGHTS / ClusteredLighting::LIGHTS_PER_ROW <= 2048, "Light texture must fit GLES 3.0's minimum texture size");
@@ -0,0 +1,205 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Graphics/Bounds.hpp"
+#include "Graphics/Frustum.hpp"
+
+/**
+ * @brief Dynamic bounding volume hierarchy over fattened AABBs.
+ *
+ * Each object is a leaf (proxy) whose box is grown by a margin, so small movements
+ * only need a containment check instead of a tree update. Leaves are inserted at the
+ * sibling that grows the tree surface area the least, and the tree is kept balanced
+ * with rotations on the way back up. Queries walk the tree with an explicit stack
+ * and report matching proxies through a callback.
+ */
+class DynamicAABBTree {
+public:
+	static constexpr int32_t NULL_NODE = -1;
+
+	DynamicAABBTree(float fatMargin = 0.1f);
+
+	// Creates a leaf for the given tight box and returns its proxy id
+	int32_t CreateProxy(const AABB& box, uint32_t userData);
+	void DestroyProxy(int32_t proxyId);
+
+	// Updates a proxy's box. Returns true if the leaf had to be reinserted,
+	// false if the tight box still fits inside the fat box
+	bool MoveProxy(int32_t proxyId, const AABB& box);
+
+	void Clear();
+
+	uint32_t GetUserData(int32_t proxyId) const { return nodes[proxyId].userData; }
+	const AABB& GetFatAABB(int32_t proxyId) const { return nodes[proxyId].box; }
+	size_t GetProxyCount() const { return proxyCount; }
+	int GetHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+	// callback(proxyId) returns false to stop the query early
+	template <typename Callback>
+	void QueryAABB(const AABB& box, Callback&& callback) const;
+
+	template <typename Callback>
+	void QuerySphere(const BoundingSphere& sphere, Callback&& callback) const;
+
+	template <typename Callback>
+	void QueryFrustum(const Frustum& frustum, Callback&& callback) const;
+
+	// callback(proxyId, maxDistance) returns the new max distance: 0 to stop, a smaller
+	// value to clip the ray to the closest hit so far, or maxDistance to continue unchanged
+	template <typename Callback>
+	void RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const;
+
+	// Slab test against a box, distance is the entry point (0 if the origin is inside)
+	static bool RayIntersectsAABB(const glm::vec3& origin, const glm::vec3& invDirection, const AABB& box, float maxDistance, float& distance);
+
+private:
+	struct Node {
+		AABB box;
+		uint32_t userData = 0;
+		int32_t parent = NULL_NODE; // Doubles as the next free node while on the free list
+		int32_t child1 = NULL_NODE;
+		int32_t child2 = NULL_NODE;
+		int32_t height = -1;        // Leaf = 0, free node = -1
+
+		bool IsLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t nodeId);
+
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	int32_t Balance(int32_t nodeId);
+
+	static AABB Combine(const AABB& a, const AABB& b);
+	static float SurfaceArea(const AABB& box);
+	static bool Contains(const AABB& outer, const AABB& inner);
+	static bool Overlaps(const AABB& a, const AABB& b);
+
+	std::vector<Node> nodes;
+	int32_t root = NULL_NODE;
+	int32_t freeList = NULL_NODE;
+	size_t proxyCount = 0;
+	float margin;
+
+	// Reused by queries so they don't allocate
+	mutable std::vector<int32_t> stack;
+};
+
+template <typename Callback>
+void DynamicAABBTree::QueryAABB(const AABB& box, Callback&& callback) const
+{
+	if (root == NULL_NODE) return;
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		int32_t nodeId = stack.back();
+		stack.pop_back();
+
+		const Node& node = nodes[nodeId];
+		if (!Overlaps(node.box, box)) continue;
+
+		if (node.IsLeaf())
+		{
+			if (!callback(nodeId)) return;
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicAABBTree::QuerySphere(const BoundingSphere& sphere, Callback&& callback) const
+{
+	if (root == NULL_NODE) return;
+
+	const float radiusSq = sphere.radius * sphere.radius;
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		int32_t nodeId = stack.back();
+		stack.pop_back();
+
+		// Distance from the sphere center to the closest point on the box
+		const Node& node = nodes[nodeId];
+		glm::vec3 closest = glm::clamp(sphere.center, node.box.min, node.box.max);
+		glm::vec3 offset = closest - sphere.center;
+		if (glm::dot(offset, offset) > radiusSq) continue;
+
+		if (node.IsLeaf())
+		{
+			if (!callback(nodeId)) return;
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicAABBTree::QueryFrustum(const Frustum& frustum, Callback&& callback) const
+{
+	if (root == NULL_NODE) return;
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		int32_t nodeId = stack.back();
+		stack.pop_back();
+
+		const Node& node = nodes[nodeId];
+		if (!frustum.IntersectsAABB(node.box)) continue;
+
+		if (node.IsLeaf())
+		{
+			if (!callback(nodeId)) return;
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicAABBTree::RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const
+{
+	if (root == NULL_NODE) return;
+
+	const glm::vec3 invDirection = 1.0f / direction;
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		int32_t nodeId = stack.back();
+		stack.pop_back();
+
+		const Node& node = nodes[nodeId];
+		float distance;
+		if (!RayIntersectsAABB(origin, invDirection, node.box, maxDistance, distance)) continue;
+
+		if (node.IsLeaf())
+		{
+			maxDistance = callback(nodeId, maxDistance);
+			if (maxDistance <= 0.0f) return;
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
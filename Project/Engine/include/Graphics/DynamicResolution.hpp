@@ -0,0 +1,85 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include "OpenGL.h"
+#include "../Engine.h"  // For ENGINE_API macro
+
+// GLES 3.0 only has timer queries through EXT_disjoint_timer_query, so Android relies on CPU frame times
+#ifndef ANDROID
+	#define DYNAMIC_RESOLUTION_GPU_TIMER 1
+#endif
+
+/**
+ * @brief Picks the render scale of the game view so frames stay within a target frame time.
+ *
+ * The cost of the view is measured with GL timer queries around its scene pass where they exist,
+ * otherwise with the CPU time between frames. Over budget, the scale drops far enough that the
+ * pixel count (scale squared) should fit again. With room to spare it creeps back up one step at
+ * a time. CPU times can't show spare room while vsync holds the frame rate, so without GPU times the
+ * scale is probed upwards after a stretch of frames on target and drops back if that misses.
+ * Scales are quantized to SCALE_STEP so the pooled render targets stay few.
+ */
+class ENGINE_API DynamicResolution {
+public:
+	static constexpr float SCALE_STEP = 0.05f;
+	static constexpr float BUDGET_HEADROOM = 0.9f;     // Aim this far under the target when scaling down
+	static constexpr float SCALE_UP_THRESHOLD = 0.75f; // GPU time below this fraction of the target scales up
+	static constexpr float SMOOTHING = 0.1f;
+	static constexpr uint32_t COOLDOWN_FRAMES = 15;    // Lets a change show in the timings before the next
+	static constexpr uint32_t PROBE_FRAMES = 120;
+	static constexpr uint32_t QUERY_COUNT = 4;         // Results are read a few frames late, never waited on
+
+	struct Settings {
+		bool enabled = false;
+		float targetFps = 60.0f;
+		float minScale = 0.5f;
+		float maxScale = 1.0f;
+	};
+
+	static DynamicResolution& GetInstance();
+
+	// Once per frame, takes the CPU timestamp and adjusts the scale
+	void Update();
+	void Shutdown();
+
+	// Around the scaled pass, on the thread that owns the context
+	void BeginGpuTimer();
+	void EndGpuTimer();
+
+	Settings& GetSettings() { return settings; }
+	bool IsEnabled() const { return settings.enabled; }
+	// 1 while disabled
+	float GetScale() const { return settings.enabled ? scale : 1.0f; }
+
+	double GetCpuFrameMs() const { return cpuFrameMs; }
+	double GetGpuFrameMs() const { return gpuFrameMs; }
+	bool HasGpuTimings() const { return gpuTimingsValid; }
+
+private:
+	DynamicResolution();
+	~DynamicResolution() = default;
+
+	DynamicResolution(const DynamicResolution&) = delete;
+	DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+	void ReadGpuTimers();
+	void SetScale(float newScale);
+
+	Settings settings;
+	float scale = 1.0f;
+	double smoothedMs = 0.0;
+	uint32_t cooldown = 0;
+	uint32_t framesOnTarget = 0;
+
+	std::chrono::steady_clock::time_point lastFrameTime;
+	bool hasLastFrameTime = false;
+	double cpuFrameMs = 0.0;
+	double gpuFrameMs = 0.0;
+	bool gpuTimingsValid = false;
+	bool gpuTimingUpdated = false;
+
+	GLuint queries[QUERY_COUNT] = {};
+	bool queryPending[QUERY_COUNT] = {};
+	uint32_t nextQuery = 0;
+	bool queryActive = false;
+};
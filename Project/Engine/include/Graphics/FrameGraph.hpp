@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Graphics/RenderTargetPool.hpp"
+
+/**
+ * @brief Declares the frame's render passes and the targets they use, then runs them in order.
+ *
+ * Transient targets only exist between the first and last pass that uses them. They are taken
+ * from the RenderTargetPool right before and handed back right after, so a later pass asking for
+ * a compatible target draws into the same memory. Imported targets belong to the caller and
+ * outlive the graph (e.g. views the editor UI shows afterwards). Passes whose results end up
+ * neither imported nor read by another pass are skipped.
+ */
+class FrameGraph {
+public:
+	using Resource = uint32_t;
+	static constexpr Resource INVALID_RESOURCE = 0xFFFFFFFFu;
+
+	using ExecuteFunction = std::function<void(const FrameGraph&)>;
+
+	Resource Create(const std::string& name, const RenderTargetDesc& desc);
+	Resource Import(const std::string& name, RenderTarget* target);
+	void AddPass(const std::string& name, std::vector<Resource> reads, std::vector<Resource> writes, ExecuteFunction execute);
+
+	// Culls, works out transient lifetimes and runs the passes in the order they were added
+	void Execute();
+	void Clear();
+
+	// Only valid while the passes using the resource run
+	RenderTarget* GetTarget(Resource resource) const;
+	const RenderTargetDesc& GetDesc(Resource resource) const { return resources[resource].desc; }
+	GLuint GetFramebuffer(Resource color, Resource depth) const;
+
+	size_t GetPassCount() const { return passes.size(); }
+	size_t GetExecutedPassCount() const { return executedPassCount; }
+
+private:
+	static constexpr uint32_t NO_PASS = 0xFFFFFFFFu;
+
+	struct ResourceNode {
+		std::string name;
+		RenderTargetDesc desc;
+		RenderTarget* target = nullptr;
+		bool imported = false;
+		std::vector<uint32_t> writers;
+		uint32_t refCount = 0;      // Passes still reading it, plus one if imported
+		uint32_t firstPass = NO_PASS;
+		uint32_t lastPass = NO_PASS;
+	};
+
+	struct PassNode {
+		std::string name;
+		std::vector<Resource> reads;
+		std::vector<Resource> writes;
+		ExecuteFunction execute;
+		uint32_t refCount = 0;      // Written resources someone still needs
+		std::vector<Resource> acquires;
+		std::vector<Resource> releases;
+	};
+
+	void Compile();
+
+	std::vector<ResourceNode> resources;
+	std::vector<PassNode> passes;
+	size_t executedPassCount = 0;
+};
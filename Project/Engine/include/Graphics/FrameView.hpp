@@ -0,0 +1,24 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "Graphics/Frustum.hpp"
+
+class Camera;
+
+// Everything derived from the camera for one rendered view. Built once per camera per
+// frame and passed down the render path instead of recomputing matrices per draw.
+struct FrameView {
+	glm::mat4 view{ 1.0f };
+	glm::mat4 projection{ 1.0f };
+	glm::mat4 viewProjection{ 1.0f };
+	Frustum frustum;
+
+	glm::vec3 cameraPosition{ 0.0f };
+	glm::vec3 cameraFront{ 0.0f, 0.0f, -1.0f };
+
+	int viewportWidth = 1;
+	int viewportHeight = 1;
+	float nearPlane = 0.1f;
+	float farPlane = 100.0f;
+
+	static FrameView Build(const Camera& camera, int viewportWidth, int viewportHeight, float nearPlane, float farPlane);
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Graphics/Bounds.hpp"
+
+// View frustum as six inward facing planes (xyz = normal, w = distance), extracted from a view-projection matrix
+class Frustum {
+public:
+	enum Plane { PLANE_LEFT = 0, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+
+	Frustum() = default;
+	static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+	bool IntersectsSphere(const BoundingSphere& sphere) const;
+	bool IntersectsAABB(const AABB& box) const;
+
+	// Tests count spheres stored as separate x/y/z/radius arrays, writing 1 (inside or
+	// intersecting) or 0 (outside) per sphere. Uses SSE or NEON four spheres at a time when available.
+	void TestSpheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t count, uint8_t* outVisible) const;
+
+	const glm::vec4& GetPlane(int index) const { return planes[index]; }
+
+private:
+	glm::vec4 planes[PLANE_COUNT]{};
+};
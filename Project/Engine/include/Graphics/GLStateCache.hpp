@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include "OpenGL.h"
+#include "../Engine.h"  // For ENGINE_API macro
+
+// Shadows the GL state the renderer touches most often and skips calls that would not change it.
+// Any code that changes this state directly (ImGui, framebuffer setup, etc.) must either go
+// through the cache or call Invalidate() afterwards so the shadow copy is re-learned.
+class ENGINE_API GLStateCache {
+public:
+	static constexpr GLuint MAX_TEXTURE_UNITS = 16;
+
+	struct Stats {
+		uint32_t issued = 0;
+		uint32_t skipped = 0;
+	};
+
+	static GLStateCache& GetInstance();
+
+	// Rolls the per-frame counters over and forgets all shadowed state
+	void BeginFrame();
+	// Marks every tracked value as unknown so the next call always reaches GL
+	void Invalidate();
+
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vao);
+	// Binds a texture to the given unit, switching the active unit only if needed.
+	// Names are unique across targets, so one shadow per unit covers 2D and array textures
+	void BindTexture(GLuint unit, GLuint texture, GLenum target = GL_TEXTURE_2D);
+
+	void SetBlend(bool enabled);
+	void SetBlendFunc(GLenum srcFactor, GLenum dstFactor);
+	void SetDepthTest(bool enabled);
+	void SetDepthWrite(bool enabled);
+	void SetCullFace(bool enabled);
+
+	// Deleted GL names can be reused by the driver, so drop any shadowed binding that refers to them
+	void OnProgramDeleted(GLuint program);
+	void OnVertexArrayDeleted(GLuint vao);
+	void OnTextureDeleted(GLuint texture);
+
+	const Stats& GetFrameStats() const { return currentStats; }
+	const Stats& GetLastFrameStats() const { return lastFrameStats; }
+
+private:
+	GLStateCache();
+	~GLStateCache() = default;
+
+	GLStateCache(const GLStateCache&) = delete;
+	GLStateCache& operator=(const GLStateCache&) = delete;
+
+	static constexpr GLuint UNKNOWN_NAME = 0xFFFFFFFFu;
+	static constexpr GLenum UNKNOWN_ENUM = 0xFFFFFFFFu;
+
+	// -1 = unknown, 0 = disabled, 1 = enabled
+	void SetCapability(int8_t& shadow, GLenum capability, bool enabled);
+
+	GLuint program = UNKNOWN_NAME;
+	GLuint vertexArray = UNKNOWN_NAME;
+	GLuint activeUnit = UNKNOWN_NAME;
+	GLuint boundTextures[MAX_TEXTURE_UNITS];
+
+	int8_t blend = -1;
+	int8_t depthTest = -1;
+	int8_t depthWrite = -1;
+	int8_t cullFace = -1;
+	GLenum blendSrc = UNKNOWN_ENUM;
+	GLenum blendDst = UNKNOWN_ENUM;
+
+	Stats currentStats;
+	Stats lastFrameStats;
+};
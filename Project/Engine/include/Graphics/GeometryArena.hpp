@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "OpenGL.h"
+#include "VBO.h"
+#include "VertexFormat.hpp"
+#include "../Engine.h"  // For ENGINE_API macro
+
+// GLES 3.0 can't offset indices at draw time, so they are offset when uploaded instead
+#ifdef ANDROID
+	#define GEOMETRY_ARENA_REBASE_INDICES 1
+#endif
+
+// First-fit range allocator with coalescing, used to hand out vertex and index ranges within a page
+class RangeAllocator {
+public:
+	static constexpr uint32_t INVALID_OFFSET = 0xFFFFFFFFu;
+
+	RangeAllocator() = default;
+	explicit RangeAllocator(uint32_t capacity);
+
+	uint32_t Allocate(uint32_t size);
+	void Free(uint32_t offset, uint32_t size);
+
+	uint32_t GetCapacity() const { return capacity; }
+	uint32_t GetUsed() const { return used; }
+
+private:
+	std::map<uint32_t, uint32_t> freeBlocks; // offset -> size, ordered so neighbours can be merged
+	uint32_t capacity = 0;
+	uint32_t used = 0;
+};
+
+// Where a mesh's geometry lives inside the arena
+struct GeometryAllocation {
+	static constexpr uint32_t INVALID_PAGE = 0xFFFFFFFFu;
+
+	uint32_t page = INVALID_PAGE;
+	uint32_t vertexOffset = 0;
+	uint32_t vertexCount = 0;
+	uint32_t indexOffset = 0;       // In 4-byte words, so both index types stay aligned
+	uint32_t indexWords = 0;
+	uint32_t indexCount = 0;
+	GLenum indexType = GL_UNSIGNED_INT;
+
+	bool IsValid() const { return page != INVALID_PAGE; }
+};
+
+/**
+ * @brief Shared vertex/index storage for every Mesh.
+ *
+ * Geometry is packed into a few large pages, each one VBO + EBO + VAO for the PackedVertex format.
+ * Meshes only hold their offsets, so consecutive draws from the same page never rebind
+ * buffers or VAOs. On desktop the draws use base vertex; GLES 3.0 has no base vertex draws,
+ * so there the indices are rebased to the page when they are uploaded. Index ranges that fit
+ * are stored as 16-bit; on GLES pages hold 65536 vertices so rebased indices still fit.
+ */
+class ENGINE_API GeometryArena {
+public:
+#ifdef GEOMETRY_ARENA_REBASE_INDICES
+	static constexpr uint32_t VERTICES_PER_PAGE = 1u << 16;
+#else
+	static constexpr uint32_t VERTICES_PER_PAGE = 1u << 18;
+#endif
+	static constexpr uint32_t INDEX_WORDS_PER_PAGE = 1u << 20;
+
+	struct Stats {
+		size_t pageCount = 0;
+		size_t allocationCount = 0;
+		size_t reservedBytes = 0;   // GPU memory owned by the arena
+		size_t usedBytes = 0;       // Portion of it holding live geometry
+	};
+
+	static GeometryArena& GetInstance();
+
+	GeometryAllocation Allocate(const std::vector<PackedVertex>& vertices, const std::vector<GLuint>& indices);
+	void Free(GeometryAllocation& allocation);
+
+	// Releases all GL objects. Allocations made before this become invalid
+	void Shutdown();
+
+	void Draw(const GeometryAllocation& allocation);
+	// Draws instanceCount copies, reading one model matrix per instance from instanceBuffer at byteOffset
+	void DrawInstanced(const GeometryAllocation& allocation, VBO& instanceBuffer, size_t byteOffset, GLsizei instanceCount, GLuint matrixLocation);
+
+	Stats GetStats() const;
+
+private:
+	GeometryArena() = default;
+	~GeometryArena() = default;
+
+	GeometryArena(const GeometryArena&) = delete;
+	GeometryArena& operator=(const GeometryArena&) = delete;
+
+	struct Page {
+		GLuint vao = 0;
+		GLuint vbo = 0;
+		GLuint ebo = 0;
+		RangeAllocator vertices;
+		RangeAllocator indices;     // In 4-byte words
+		size_t allocationCount = 0;
+	};
+
+	uint32_t CreatePage(uint32_t vertexCapacity, uint32_t indexWordCapacity);
+	void BindPage(const Page& page);
+
+	std::vector<Page> pages;
+	// Scratch for uploads that need rebasing or narrowing
+	std::vector<GLuint> indices32;
+	std::vector<uint16_t> indices16;
+};
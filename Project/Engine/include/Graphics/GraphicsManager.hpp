@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <vector>
 #include <memory>
 #include <glm/glm.hpp>
@@ -7,9 +8,14 @@
 #include "Graphics/Camera.h"
 #include "Graphics/ShaderClass.h"
 #include "Graphics/Model/Model.h"
+#include "Graphics/RenderQueue.hpp"
+#include "Graphics/RenderFrame.hpp"
+#include "Graphics/RenderWorld.hpp"
+#include "Graphics/FrameView.hpp"
 #include "Model/ModelRenderComponent.hpp"
 #include "TextRendering/Font.hpp"
 #include "TextRendering/TextRenderComponent.hpp"
+#include "TextRendering/TextBatcher.hpp"
 #include <Math/Matrix4x4.hpp>
 
 class GraphicsManager {
@@ -20,7 +26,8 @@ public:
 	bool Initialize(int window_width, int window_height);
 	void Shutdown();
 
-    // Frame management
+    // Frame management. NewFrame() starts an application frame, which may draw several views
+    void NewFrame();
     void BeginFrame();
     void EndFrame();
     void Clear(float r = 0.2f, float g = 0.3f, float b = 0.3f, float a = 1.0f);
@@ -29,16 +36,40 @@ public:
     void SetCamera(Camera* camera);
     Camera* GetCurrentCamera() const { return currentCamera; }
 
+    // View constants for the current camera, rebuilt on first use after the camera or frame changes
+    const FrameView& GetFrameView();
+
+    // The render world shared by every view this frame. Returns a cleared world for the caller to
+    // extract the scene into, or null when that was already done this frame
+    RenderWorld* BeginWorldExtraction();
+
     // Render queue management
     void Submit(std::unique_ptr<IRenderComponent> renderItem);
-    void SubmitModel(std::shared_ptr<Model> model, std::shared_ptr<Shader> shader, const Matrix4x4& transform);
+    void SubmitModel(std::shared_ptr<Model> model, std::shared_ptr<Shader> shader, const Matrix4x4& transform, uint32_t lodLevel = 0);
+    // Mesh already in world space (static batches). Both must stay alive until the frame is drawn,
+    // which with the render thread is after Render() returns (see RenderThread::ContextScope)
+    void SubmitStaticMesh(Mesh* mesh, Shader* shader, int renderOrder);
+
+    // GL work outside the draw packets (debug geometry and the like). Runs right away, or after
+    // this frame's packets on the render thread. Capture by value, scene state may have moved on
+    void SubmitRenderCommand(std::function<void()> command);
 
-    // Main rendering
+    // Main rendering. Records the view into the current frame, and draws it unless the render thread will
     void Render();
+    // Draws a recorded frame on the thread that owns the context
+    void ExecuteFrame(RenderFrame& frame);
+
+    // Culling statistics for the last rendered view
+    size_t GetCulledCount() const { return culledCount; }
+    size_t GetVisibleCount() const { return visibleCount; }
+
 
+    static glm::mat4 ConvertMatrix4x4ToGLM(const Matrix4x4& m);
 
     // Text Rendering
     void SubmitText(const std::string& text, std::shared_ptr<Font> font, std::shared_ptr<Shader> shader, const glm::vec3& position, const glm::vec3& color = glm::vec3(1.0f), float scale = 1.0f, bool is3D = false, const glm::mat4& transform = glm::mat4(1.0f));
+    // Component is drawn in place and must stay alive until Render()
+    void SubmitText(const TextRenderComponent& textItem);
 private:
     GraphicsManager() = default;
     ~GraphicsManager() = default;
@@ -46,19 +77,105 @@ private:
     GraphicsManager(const GraphicsManager&) = delete;
     GraphicsManager& operator=(const GraphicsManager&) = delete;
 
+    // Culled packets of one range of the render queue, built by a job and merged in range order
+    struct ExtractSlice {
+        std::vector<DrawPacket> packets;
+
+        // Frustum culling, spheres are kept as separate arrays so they can be tested four at a time
+        std::vector<uint8_t> itemVisible;   // Parallel to the range
+        std::vector<uint32_t> cullItemIndices;
+        std::vector<float> cullCenterX;
+        std::vector<float> cullCenterY;
+        std::vector<float> cullCenterZ;
+        std::vector<float> cullRadius;
+        std::vector<uint8_t> cullResults;
+        size_t culledCount = 0;
+        size_t visibleCount = 0;
+    };
+    static constexpr uint32_t EXTRACT_RANGE_SIZE = 256;
+
+    // Sorted draw packet pipeline
+    void BuildLayerOrders(const RenderWorld* world);
+    uint32_t GetLayer(int renderOrder) const;
+    void BuildDrawPackets(const FrameView& frameView, RenderQueue& drawQueue, const RenderWorld* world);
+    // Culls items [begin, end) and writes their packets to slice. Runs on job threads
+    void ExtractRange(uint32_t begin, uint32_t end, ExtractSlice& slice, const FrameView& frameView);
+    // Same for world instances [begin, end) of worldCandidates, also picking their LOD for this view
+    void ExtractWorldRange(uint32_t begin, uint32_t end, ExtractSlice& slice, const RenderWorld& world, const FrameView& frameView, uint8_t* lodLevels);
+    // Per entity LODs the current camera last drew with
+    uint8_t* GetViewLODLevels();
+    void AddModelPackets(Model& model, Shader* shader, const glm::mat4& transform, uint32_t lodLevel, uint32_t layer, const FrameView& frameView, std::vector<DrawPacket>& packets);
+    void AddTextPacket(const TextRenderComponent& textItem, uint32_t layer, const FrameView& frameView, std::vector<DrawPacket>& packets);
+    void BuildDrawBatches(const RenderQueue& drawQueue);
+    void UploadInstanceTransforms();
+    void ExecuteDrawPackets(const RenderQueue& drawQueue, const FrameView& frameView);
+
+    // A run of sorted packets drawn together. Runs of identical mesh/material/shader become one instanced draw,
+    // runs of text sharing a font atlas and shader become one draw from the text batcher
+    struct DrawBatch {
+        static constexpr uint32_t NOT_INSTANCED = 0xFFFFFFFFu;
+
+        uint32_t first;             // Index into the sorted entries
+        uint32_t count;
+        uint32_t instanceOffset;    // First matrix in instanceTransforms, or NOT_INSTANCED
+        uint32_t firstVertex = 0;   // Text only, range in the text batcher
+        uint32_t vertexCount = 0;
+    };
+    static constexpr uint32_t MIN_INSTANCE_COUNT = 2;
+
     // Private model rendering methods
-    void RenderModel(const ModelRenderComponent& item);
-    void ApplyLighting(Shader& shader);
-    void SetupMatrices(Shader& shader, const glm::mat4& modelMatrix);
-    glm::mat4 ConvertMatrix4x4ToGLM(const Matrix4x4& m);
+    void UpdateFrameUniforms(const FrameView& frameView, const LightSet& lights);
     Matrix4x4 ConvertGLMToMatrix4x4(const glm::mat4& m);
 
     // Private text rendering methods
-    void RenderText(const TextRenderComponent& item);
-    void Setup2DTextMatrices(Shader& shader, const glm::vec3& position, float scale);
+    void RenderTextBatch(const TextRenderComponent& head, const DrawBatch& batch, const FrameView& frameView);
 
     std::vector<std::unique_ptr<IRenderComponent>> renderQueue;
+
+    struct StaticMeshDraw {
+        Mesh* mesh;
+        Shader* shader;
+        int renderOrder;
+    };
+    std::vector<StaticMeshDraw> staticMeshQueue;
+    std::vector<const TextRenderComponent*> textQueue;
+    RenderFrame directFrame;                // Used when there is no render thread
+    RenderFrame* recordingFrame = nullptr;
+    bool deferredFrame = false;             // recordingFrame is drawn later by the render thread
+    std::vector<int> layerOrders;
+
+    // World shared by this frame's views. Worlds referenced by frames in flight aren't refilled
+    std::vector<std::shared_ptr<RenderWorld>> worldPool;
+    std::shared_ptr<RenderWorld> currentWorld;
+    uint64_t frameNumber = 0;
+    uint64_t worldFrameNumber = 0;
+    std::vector<Entity> worldQueryResults;
+    std::vector<uint32_t> worldCandidates;  // Instances that passed this view's spatial query
+
+    // LOD hysteresis needs the level each view picked last time. Views share the world, so the
+    // levels are kept per camera, indexed by entity, and dropped once a camera stops drawing
+    static constexpr uint64_t VIEW_LOD_EVICT_FRAMES = 120;
+    struct ViewLODState {
+        const Camera* camera = nullptr;
+        uint64_t lastUsedFrame = 0;
+        std::vector<uint8_t> levels;
+    };
+    std::vector<ViewLODState> viewLODStates;
+
+    std::vector<ExtractSlice> extractSlices;
+    size_t culledCount = 0;
+    size_t visibleCount = 0;
+
+    std::vector<DrawBatch> drawBatches;
+    std::vector<glm::mat4> instanceTransforms;
+    std::unique_ptr<VBO> instanceVBO;
+    size_t instanceCapacity = 0;
+    TextBatcher textBatcher;
     Camera* currentCamera = nullptr;
+    FrameView frameView;
+    bool frameViewDirty = true;
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
     int screenWidth = 0;
     int screenHeight = 0;
 
@@ -33,6 +33,14 @@ struct SpotLight {
     float outerCutOff = 0.966f; // cos(15 degrees)
 };
 
+// Copy of every light, taken once per frame so drawing never reads the live manager
+struct LightSet {
+    DirectionalLight directionalLight;
+    std::vector<PointLight> pointLights;
+    SpotLight spotLight;
+    bool spotLightEnabled = true;
+};
+
 class LightManager : public System {
 public:
     static LightManager& getInstance();
@@ -56,6 +64,8 @@ public:
     bool isSpotLightEnabled() const { return spotLightEnabled; }
 
     size_t getPointLightCount() const { return pointLights.size(); }
+    // Copies the current lights into lights, reusing its storage
+    void captureLights(LightSet& lights) const;
     void clearAllLights();
 
     void printLightStats() const;
@@ -45,6 +45,10 @@ public:
 	// Utility methods
 	void setName(const std::string& name);
 	const std::string& getName() const;
+	float getOpacity() const { return m_opacity; }
+
+	// Compact id used to group draws by material in the render queue sort key
+	uint32_t getSortId() const { return m_sortId; }
 
 	// Apply material to shader
 	void applyToShader(Shader& shader) const;
@@ -58,6 +62,9 @@ public:
 	void debugPrintProperties() const;
 private:
 	std::string m_name;
+	uint32_t m_sortId;
+
+	static uint32_t s_nextSortId;
 
 	// Basic material properties
 	glm::vec3 m_ambient{ 0.2f, 0.2f, 0.2f };
@@ -77,6 +84,8 @@ private:
 
 	// Helper methods
 	std::string textureTypeToString(TextureType type) const;
+	static UniformID textureTypeToUniform(TextureType type);
+	static GLuint textureTypeToUnit(TextureType type);
 	void bindTextures(Shader& shader) const;
 
 };
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "Camera.h"
 #include "Texture.h"
 #include "Material.hpp"
+#include "Bounds.hpp"
+#include "GeometryArena.hpp"
 
 class Mesh {
 public:
@@ -13,12 +15,37 @@ public:
 	std::vector<std::shared_ptr<Texture>> textures;
 	std::shared_ptr<Material> material;
 
+	// Local space bounds, computed from the vertices when the mesh is created
+	AABB localBounds;
+	BoundingSphere localSphere;
+
 	Mesh() {};
 	Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::vector<std::shared_ptr<Texture>>& textures);
 	Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::shared_ptr<Material> mat);
 
 	~Mesh();
-	void Draw(Shader& shader, const Camera& camera);
+	void Draw(Shader& shader);
+
+	// Levels of detail including the mesh itself (LOD 0), each coarser one roughly halves the triangles
+	static constexpr uint32_t MAX_LODS = 4;
+	// Adds the next coarser level. Vertices must lie within the base mesh bounds
+	void AddLOD(const std::vector<Vertex>& lodVertices, const std::vector<GLuint>& lodIndices, float error);
+	uint32_t GetLODCount() const { return 1 + static_cast<uint32_t>(lods.size()); }
+	uint32_t GetTriangleCount(uint32_t lod = 0) const;
+
+	// Lower level pieces of Draw, used by the render queue so it can skip redundant state changes
+	void ApplyMaterial(Shader& shader);
+	// Sets the uniforms that decode this mesh's packed vertex positions
+	void ApplyGeometry(Shader& shader);
+	void DrawGeometry(uint32_t lod = 0);
+	// Draws instanceCount copies, reading one model matrix per instance from instanceBuffer at byteOffset
+	void DrawGeometryInstanced(VBO& instanceBuffer, size_t byteOffset, GLsizei instanceCount, uint32_t lod = 0);
+
+	// First attribute location of the per-instance model matrix (a mat4 spans four locations)
+	static constexpr GLuint INSTANCE_MATRIX_LOCATION = 4;
+
+	// Compact id used to group draws by mesh in the render queue sort key
+	uint32_t GetSortId() const { return sortId; }
 
 	Mesh(const Mesh& other) = delete;  // Prevent copying
 	Mesh& operator=(const Mesh& other) = delete;  // Prevent assignment
@@ -28,9 +55,39 @@ public:
 		indices(std::move(other.indices)),
 		textures(std::move(other.textures)),
 		material(std::move(other.material)),
-		vao(std::move(other.vao)) {}
+		localBounds(other.localBounds),
+		localSphere(other.localSphere),
+		geometry(other.geometry),
+		positionDecode(other.positionDecode),
+		lods(std::move(other.lods)),
+		textureUniformNames(std::move(other.textureUniformNames)),
+		textureUniforms(std::move(other.textureUniforms)),
+		sortId(other.sortId) {
+		other.geometry = GeometryAllocation(); // The moved-from mesh must not free the range
+		other.lods.clear();
+	}
+
+	const GeometryAllocation& GetGeometry(uint32_t lod = 0) const;
 
 private:
-	VAO vao;
+	// Range of the shared geometry arena holding this mesh's vertices and indices
+	GeometryAllocation geometry;
+	PositionDecode positionDecode;
+
+	struct LOD {
+		GeometryAllocation geometry;
+		float error;                // Simplification error relative to the mesh size
+	};
+	std::vector<LOD> lods;
+
+	// Sampler uniform of each texture for meshes without a material, named once instead of per draw.
+	// The ids point into the names for diagnostics, moving the vector keeps the strings in place
+	std::vector<std::string> textureUniformNames;
+	std::vector<UniformID> textureUniforms;
+	uint32_t sortId = nextSortId++;
+
+	static inline uint32_t nextSortId = 0;
 	void setupMesh();
+	void setupTextureUniforms();
+	void computeBounds();
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Graphics/VBO.h"
+#include "OpenGL.h"
+
+// Post-transform cache efficiency of an index buffer, simulated with a FIFO cache
+struct VertexCacheStats {
+	size_t triangles = 0;
+	size_t vertices = 0;        // Distinct vertices referenced
+	size_t transformed = 0;     // Cache misses, i.e. vertex shader invocations
+
+	// Average cache miss ratio: transformed vertices per triangle (0.5 is ideal, 3 is worst)
+	float ACMR() const { return triangles ? static_cast<float>(transformed) / triangles : 0.0f; }
+	// Average transform to vertex ratio: transformed vertices per vertex (1 is ideal)
+	float ATVR() const { return vertices ? static_cast<float>(transformed) / vertices : 0.0f; }
+
+	void Add(const VertexCacheStats& other)
+	{
+		triangles += other.triangles;
+		vertices += other.vertices;
+		transformed += other.transformed;
+	}
+};
+
+/**
+ * @brief Import time optimization of triangle lists for the GPU.
+ *
+ * Optimize runs the full pipeline on one mesh:
+ *  1. WeldVertices merges bit-identical vertices so shared corners are transformed once.
+ *  2. OptimizeVertexCache reorders triangles for the post-transform cache (Forsyth's linear-speed algorithm).
+ *  3. OptimizeOverdraw splits that order into clusters at cache restarts and sorts the clusters
+ *     so outward facing ones draw first, trading a little cache efficiency for early-z rejection.
+ *  4. OptimizeVertexFetch reorders vertices by first use so fetches walk memory linearly.
+ * Models bake the result into their cooked cache, so none of this runs when a model is loaded again.
+ */
+class MeshOptimizer {
+public:
+	// Cache size used for the ACMR/ATVR simulation, matches typical hardware FIFO caches
+	static constexpr size_t SIMULATED_CACHE_SIZE = 16;
+	// Allowed ACMR growth over the cache optimized order when splitting overdraw clusters
+	static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+	struct Report {
+		size_t sourceVertices = 0;
+		size_t optimizedVertices = 0;
+		VertexCacheStats before;
+		VertexCacheStats after;
+	};
+
+	static Report Optimize(std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
+
+	static VertexCacheStats AnalyzeVertexCache(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize = SIMULATED_CACHE_SIZE);
+
+	static void WeldVertices(std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
+	static void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+	static void OptimizeOverdraw(std::vector<GLuint>& indices, const std::vector<Vertex>& vertices, float threshold = OVERDRAW_THRESHOLD);
+	static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
+};
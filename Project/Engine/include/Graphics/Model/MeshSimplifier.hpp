@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Graphics/VBO.h"
+#include "OpenGL.h"
+
+/**
+ * @brief Quadric error metric simplifier (Garland-Heckbert) for building LODs at import time.
+ *
+ * Works on the index buffer only: edges are collapsed onto one of their existing vertices,
+ * so every LOD can reuse the base vertex data. Each vertex accumulates the planes of the
+ * triangles it has absorbed and a collapse costs the squared distance of the target from them.
+ * Vertices on open borders or attribute seams (UV/normal splits) are locked so outlines and
+ * texture mapping hold, and collapses that would flip a triangle are rejected.
+ */
+class MeshSimplifier {
+public:
+	// Collapses edges until indices has at most targetIndexCount entries or the next collapse would
+	// exceed maxError. Errors are relative to the mesh extent. Returns the error actually reached
+	static float Simplify(const std::vector<Vertex>& vertices, std::vector<GLuint>& indices, size_t targetIndexCount, float maxError);
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "Graphics/Mesh.h"
+#include "Graphics/TriangleBVH.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -15,14 +16,55 @@ public:
 	std::vector<Mesh> meshes;
 	std::string directory;
 
+	// Local space bounds enclosing every mesh
+	AABB localBounds;
+	BoundingSphere localSphere;
+
+	// Triangle hierarchy for exact picking, in model space
+	TriangleBVH triangleBVH;
+
 	//Model(const std::string& filePath);
 	bool LoadAsset(const std::string& path) override;
-	void Draw(Shader& shader, const Camera& camera);
+	void Draw(Shader& shader);
+
+	// Most LODs of any mesh, 1 when nothing could be simplified
+	uint32_t GetLODCount() const { return lodCount; }
+
+	// Closest triangle hit by a ray given in model space
+	bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleRayHit& hit) const;
 
 private:
+	// Optimized vertex/index data for one mesh and its coarser LODs, as stored in the cooked file
+	struct LODGeometry {
+		std::vector<Vertex> vertices;
+		std::vector<GLuint> indices;
+		float error = 0.0f;
+	};
+	struct MeshGeometry {
+		std::vector<Vertex> vertices;
+		std::vector<GLuint> indices;
+		std::vector<LODGeometry> lods;
+	};
+
+	// Bump when the cooked layout or the optimization pipeline changes, so old files are rebuilt
+	static constexpr uint32_t COOKED_VERSION = 2;
+
+	// LOD generation: stop once a level can't get under this many triangles or this error (relative to mesh size)
+	static constexpr size_t MIN_LOD_TRIANGLES = 64;
+	static constexpr float MAX_LOD_ERROR = 0.05f;
+
 	//void loadModel(const std::string& path);
-	void processNode(aiNode* node, const aiScene* scene);
-	Mesh processMesh(aiMesh* mesh, const aiScene* scene);
+	void processNode(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& sourceMeshes);
+	void computeBounds();
+
+	uint32_t lodCount = 1;
+	void extractGeometry(aiMesh* mesh, MeshGeometry& geometry);
+	void generateLODs(MeshGeometry& geometry);
+	Mesh processMesh(aiMesh* mesh, const aiScene* scene, MeshGeometry& geometry);
+
+	// Cooked geometry lives next to the source as <path>.cooked and is tied to the source's write time
+	bool loadCookedGeometry(const std::string& path, size_t meshCount, std::vector<MeshGeometry>& geometry);
+	void saveCookedGeometry(const std::string& path, const std::vector<MeshGeometry>& geometry);
 	std::vector<std::shared_ptr<Texture>> loadMaterialTexture(aiMaterial* mat, aiTextureType type, std::string typeName);
 
 };
\ No newline at end of file
@@ -13,6 +13,12 @@ public:
 	std::shared_ptr<Shader> shader;
 	glm::mat4 transform;
 
+	// Static entities never move, so their meshes get merged into world space batches
+	bool isStatic = false;
+
+	// Level of detail for models submitted directly, scene models get theirs picked per view
+	uint32_t lodLevel = 0;
+
 	ModelRenderComponent(std::shared_ptr<Model> m, std::shared_ptr<Shader> s) 
 		: model(std::move(m)), shader(std::move(s)), transform(){}
 	ModelRenderComponent() = default;
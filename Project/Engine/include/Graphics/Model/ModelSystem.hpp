@@ -5,6 +5,8 @@
 #include "Model.h"
 #include "Graphics/Camera.h"
 #include "Graphics/ShaderClass.h"
+#include "Graphics/StaticBatcher.hpp"
+#include "Graphics/RenderWorld.hpp"
 
 class ModelSystem : public System {
 public:
@@ -12,6 +14,20 @@ public:
     ~ModelSystem() = default;
 
     bool Initialise();
-    void Update();
+    // Gathers visible models into the frame's render world, each view culls them for its own camera
+    void Extract(RenderWorld& world);
     void Shutdown();
+
+    // Re-merges static entities, done automatically when one is added, moved or removed
+    void BuildStaticBatches();
+
+    // LOD n + 1 is used once a model's bounding sphere covers less than LOD_SCREEN_COVERAGE[n] of the screen height
+    static constexpr float LOD_SCREEN_COVERAGE[Mesh::MAX_LODS - 1] = { 0.5f, 0.25f, 0.125f };
+    // How far past a threshold a model has to get before switching, so models sitting on one don't pop back and forth
+    static constexpr float LOD_HYSTERESIS = 0.15f;
+
+    static uint32_t SelectLOD(float screenCoverage, uint32_t currentLOD, uint32_t lodCount);
+
+private:
+    StaticBatcher staticBatcher;
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Graphics/FrameView.hpp"
+#include "Graphics/IRenderComponent.hpp"
+#include "Graphics/LightManager.hpp"
+#include "Graphics/RenderQueue.hpp"
+#include "Graphics/RenderWorld.hpp"
+
+/**
+ * @brief Everything needed to draw one view, captured on the main thread.
+ *
+ * Once recorded the frame doesn't read scene state again: submitted items are owned by it,
+ * the render world it was culled from stays alive with it, text submitted by reference is
+ * copied in when drawing is deferred, and lights are copied
+ * out of the LightManager. That lets the render thread draw it while the next frame updates.
+ */
+struct RenderFrame {
+	FrameView view;
+	bool hasView = false;
+
+	bool clear = false;
+	glm::vec4 clearColor{ 0.0f };
+
+	LightSet lights;
+	RenderQueue drawQueue;  // Sorted
+	// Culling runs while recording, the counts are reported with the rest of the stats once drawn
+	uint32_t visibleObjects = 0;
+	uint32_t culledObjects = 0;
+
+	// Items the draw packets point into, kept alive until the frame has been drawn
+	std::vector<std::unique_ptr<IRenderComponent>> ownedItems;
+	std::shared_ptr<const RenderWorld> world;
+
+	// GL work that isn't a draw packet, run in order after the packets
+	std::vector<std::function<void()>> commands;
+
+	void Reset()
+	{
+		hasView = false;
+		clear = false;
+		drawQueue.Clear();
+		visibleObjects = 0;
+		culledObjects = 0;
+		ownedItems.clear();
+		world.reset();
+		commands.clear();
+	}
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Mesh;
+class Material;
+class Shader;
+class IRenderComponent;
+
+/**
+ * @brief One draw request in the sorted render queue.
+ *
+ * Models expand into one packet per mesh. Items that are not meshes (e.g. text)
+ * become a single packet that points back at the submitted render component.
+ */
+struct DrawPacket {
+	uint64_t sortKey = 0;
+	Mesh* mesh = nullptr;
+	Material* material = nullptr;
+	Shader* shader = nullptr;
+	const IRenderComponent* item = nullptr; // Only set for non-mesh items
+	glm::mat4 transform{ 1.0f };
+	uint32_t lod = 0;
+	bool isTransparent = false;
+};
+
+/**
+ * @brief Packs draw state into a 64-bit key so that sorting groups draws by state.
+ *
+ * Layout, most significant bits first:
+ *   [63..56] layer        - dense index of the item's renderOrder
+ *   [55]     translucency - opaque packets draw before transparent ones within a layer
+ *   Opaque:      program(10) | material(12) | mesh(12) | lod(2) | depth(19), front-to-back
+ *   Transparent: depth(19), back-to-front | program(10) | material(12) | mesh(12) | lod(2)
+ * Program, material and mesh ids wrap once they outgrow their fields. That only weakens the
+ * grouping, batches still compare the real pointers.
+ */
+namespace RenderSortKey {
+	constexpr uint32_t LAYER_BITS = 8;
+	constexpr uint32_t PROGRAM_BITS = 10;
+	constexpr uint32_t MATERIAL_BITS = 12;
+	constexpr uint32_t MESH_BITS = 12;
+	constexpr uint32_t LOD_BITS = 2;
+	constexpr uint32_t DEPTH_BITS = 19;
+	static_assert(LAYER_BITS + 1 + PROGRAM_BITS + MATERIAL_BITS + MESH_BITS + LOD_BITS + DEPTH_BITS == 64, "Sort key fields must fill 64 bits");
+
+	constexpr uint32_t MAX_LAYER = (1u << LAYER_BITS) - 1;
+
+	// depth01 is the view depth normalized to [0, 1] between the camera and the far plane
+	uint32_t QuantizeDepth(float depth01);
+
+	uint64_t MakeOpaque(uint32_t layer, uint32_t program, uint32_t material, uint32_t mesh, uint32_t lod, float depth01);
+	uint64_t MakeTransparent(uint32_t layer, uint32_t program, uint32_t material, uint32_t mesh, uint32_t lod, float depth01);
+}
+
+/**
+ * @brief Collects draw packets for a frame and orders them by sort key.
+ *
+ * Sorting works on (key, index) pairs with an LSD radix sort, so packets never
+ * move once added and equal keys keep their submission order.
+ */
+class RenderQueue {
+public:
+	struct SortEntry {
+		uint64_t key;
+		uint32_t index;
+	};
+
+	void Clear();
+	DrawPacket& Add();
+	// Adds packets built elsewhere (e.g. by extraction jobs) in order
+	void Append(const std::vector<DrawPacket>& slice);
+	void Sort();
+
+	size_t Size() const { return packets.size(); }
+	bool Empty() const { return packets.empty(); }
+
+	const std::vector<SortEntry>& GetSortedEntries() const { return entries; }
+	const DrawPacket& GetPacket(uint32_t index) const { return packets[index]; }
+
+private:
+	std::vector<DrawPacket> packets;
+	std::vector<SortEntry> entries;
+	std::vector<SortEntry> scratch;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "../Engine.h"  // For ENGINE_API macro
+
+// Counting is compiled in for debug builds. Release builds compile every RENDER_STATS_ADD away
+// unless the build defines RENDER_STATS_ENABLED=1
+#ifndef RENDER_STATS_ENABLED
+	#ifdef NDEBUG
+		#define RENDER_STATS_ENABLED 0
+	#else
+		#define RENDER_STATS_ENABLED 1
+	#endif
+#endif
+
+#if RENDER_STATS_ENABLED
+	#define RENDER_STATS_ADD(counter, amount) (RenderStats::GetInstance().Current().counter += (amount))
+#else
+	#define RENDER_STATS_ADD(counter, amount) ((void)0)
+#endif
+
+/**
+ * @brief Per-frame counters of the work the renderer hands to GL, with a short history for graphs.
+ *
+ * Counters are only touched on the thread that owns the context (the render thread while it
+ * runs), so they're plain integers. The frame they belong to is rolled into the history where
+ * GLStateCache starts its frame; the history is what other threads read.
+ */
+class ENGINE_API RenderStats {
+public:
+	static constexpr uint32_t HISTORY_SIZE = 240;
+
+	struct Counters {
+		uint32_t drawCalls = 0;
+		uint32_t instancedDrawCalls = 0;    // Also counted in drawCalls
+		uint64_t triangles = 0;
+		uint32_t programBinds = 0;
+		uint32_t textureBinds = 0;
+		uint32_t uniformUploads = 0;
+		uint64_t bufferUploadBytes = 0;     // Includes the clustered light lists, which stream through textures
+		uint32_t visibleObjects = 0;
+		uint32_t culledObjects = 0;
+		uint32_t glyphs = 0;
+	};
+
+	static RenderStats& GetInstance();
+
+	// Once per frame, on the thread that owns the context
+	void BeginFrame();
+	Counters& Current() { return current; }
+
+	// Safe from any thread
+	Counters GetLastFrame() const;
+	// Oldest first
+	std::vector<Counters> GetHistory() const;
+
+private:
+	RenderStats() = default;
+	~RenderStats() = default;
+
+	RenderStats(const RenderStats&) = delete;
+	RenderStats& operator=(const RenderStats&) = delete;
+
+	Counters current;
+
+	mutable std::mutex historyMutex;
+	std::array<Counters, HISTORY_SIZE> history;
+	uint32_t historyNext = 0;
+	uint32_t historyCount = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "OpenGL.h"
+
+struct RenderTargetDesc {
+	int width = 0;
+	int height = 0;
+	GLenum format = GL_RGBA8;   // Sized internal format
+};
+
+struct RenderTarget {
+	GLuint texture = 0;
+	int width = 0;              // Allocated size, can be larger than requested
+	int height = 0;
+	GLenum format = GL_RGBA8;
+	bool inUse = false;
+	uint64_t lastUsedFrame = 0;
+};
+
+/**
+ * @brief Recycles render target textures between passes, views and frames.
+ *
+ * A request is served by any free target of the same format that is at least as large, as long as
+ * it isn't more than MAX_AREA_RATIO times the size a new target would get. New targets are rounded
+ * up to SIZE_GRANULARITY, so a view being resized a few pixels at a time keeps drawing into the top
+ * left corner of the same texture instead of reallocating. Targets nobody asked for in EVICT_FRAMES
+ * frames are deleted. Framebuffers are cached per attachment pair.
+ */
+class RenderTargetPool {
+public:
+	static constexpr int SIZE_GRANULARITY = 128;
+	static constexpr float MAX_AREA_RATIO = 2.0f;
+	static constexpr uint64_t EVICT_FRAMES = 120;
+
+	static RenderTargetPool& GetInstance();
+
+	// Advances the frame counter and deletes targets that went unused for too long
+	void BeginFrame();
+	void Shutdown();
+
+	RenderTarget* Acquire(const RenderTargetDesc& desc);
+	void Release(RenderTarget* target);
+
+	// Framebuffer drawing into color and depth, either may be null. Created on first use
+	GLuint GetFramebuffer(const RenderTarget* color, const RenderTarget* depth);
+
+	size_t GetTargetCount() const { return targets.size(); }
+
+	static bool IsDepthFormat(GLenum format);
+
+private:
+	RenderTargetPool() = default;
+	~RenderTargetPool() = default;
+
+	RenderTargetPool(const RenderTargetPool&) = delete;
+	RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+	static int RoundUpSize(int size);
+	void CreateTexture(RenderTarget& target);
+	void DestroyTarget(RenderTarget& target);
+
+	struct FramebufferEntry {
+		GLuint color;
+		GLuint depth;
+		GLuint framebuffer;
+	};
+
+	std::vector<std::unique_ptr<RenderTarget>> targets;    // Pointers stay valid while in use
+	std::vector<FramebufferEntry> framebuffers;
+	uint64_t frameNumber = 0;
+};
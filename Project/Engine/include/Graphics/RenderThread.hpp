@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Graphics/RenderFrame.hpp"
+
+/**
+ * @brief Optional thread that owns the GL context and draws frames recorded by the main thread.
+ *
+ * Frames go through a ring of FRAME_SLOTS snapshots: the main thread records into a free slot
+ * and publishes it, the render thread draws published slots in order and presents them. With
+ * two slots the main thread can update and record frame N+1 while frame N is being drawn, and
+ * blocks only when it gets a full frame ahead. A third slot would let it run further ahead at
+ * the cost of another frame of latency.
+ *
+ * While the thread runs, the main thread must not make GL calls. Rare GL work such as
+ * rebuilding buffers goes through a ContextScope, which waits for the frames in flight and
+ * borrows the context for its lifetime.
+ */
+class RenderThread {
+public:
+	static constexpr uint32_t FRAME_SLOTS = 2;
+
+	static RenderThread& GetInstance();
+
+	// Hands the context over to a new render thread. Call from the thread that owns the context
+	void Start();
+	// Draws the frames still queued, stops the thread and makes the context current on the caller again
+	void Stop();
+	bool IsRunning() const { return running; }
+
+	// Blocks until a slot is free. The frame belongs to the caller until PublishFrame()
+	RenderFrame& AcquireFrame();
+	void PublishFrame();
+
+	// Blocks until every published frame has been drawn
+	void Flush();
+
+	// Borrows the context for main thread GL work, a no-op when the render thread isn't running
+	class ContextScope {
+	public:
+		ContextScope();
+		~ContextScope();
+
+		ContextScope(const ContextScope&) = delete;
+		ContextScope& operator=(const ContextScope&) = delete;
+
+	private:
+		bool borrowed = false;
+	};
+
+private:
+	RenderThread() = default;
+	~RenderThread() = default;
+
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	void ThreadLoop();
+	void DrawFrame(RenderFrame& frame);
+	void BorrowContext();
+	void ReturnContext();
+
+	RenderFrame frames[FRAME_SLOTS];
+	uint32_t writeIndex = 0;        // Next slot the main thread records into
+	uint32_t readIndex = 0;         // Next slot the render thread draws
+	uint32_t publishedCount = 0;    // Published and not yet drawn, including the one being drawn
+	bool recording = false;
+
+	bool running = false;
+	bool stopRequested = false;
+	bool contextRequested = false;
+	bool contextLent = false;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::thread thread;
+};
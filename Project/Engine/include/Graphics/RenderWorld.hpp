@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ECS/Entity.hpp"
+#include "Graphics/Bounds.hpp"
+
+class Model;
+class Shader;
+class SpatialIndexSystem;
+class StaticBatcher;
+class TextRenderComponent;
+
+/**
+ * @brief Renderables gathered from the scene once per frame and shared by every view drawn in it.
+ *
+ * Extraction (component lookups, world transforms and bounds) doesn't depend on the camera, so
+ * the editor's Scene and Game views cull and sort against the same world instead of each walking
+ * the ECS again. Views only read it, each keeps its own LOD state in GraphicsManager.
+ */
+struct RenderWorld {
+	static constexpr uint32_t NO_INSTANCE = 0xFFFFFFFFu;
+
+	struct ModelInstance {
+		Entity entity = 0;
+		std::shared_ptr<Model> model;
+		std::shared_ptr<Shader> shader;
+		glm::mat4 transform{ 1.0f };
+		BoundingSphere worldSphere;
+		AABB worldBounds;
+		int renderOrder = 0;
+	};
+
+	std::vector<ModelInstance> models;
+	std::vector<uint32_t> instanceOf;  // Entity to index in models, NO_INSTANCE when it has none
+	std::vector<const TextRenderComponent*> texts;
+
+	// Used by each view to cull, null when the scene has none
+	const SpatialIndexSystem* spatialIndex = nullptr;
+	const StaticBatcher* staticBatcher = nullptr;
+
+	void Clear()
+	{
+		models.clear();
+		instanceOf.assign(MAX_ENTITIES, NO_INSTANCE);
+		texts.clear();
+		spatialIndex = nullptr;
+		staticBatcher = nullptr;
+	}
+};
@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <functional>
+#include "Graphics/FrameGraph.hpp"
 
 #ifdef _WIN32
 #ifdef ENGINE_EXPORTS
@@ -24,40 +26,70 @@ class Camera;
  * @brief Handles scene rendering operations for editor and runtime
  *
  * This class manages framebuffer operations and scene rendering
- * specifically for editor viewports and scene previews.
+ * specifically for editor viewports and scene previews. Views are
+ * declared as passes of a frame graph while the UI is built and drawn
+ * together before the UI renders.
  */
 class ENGINE_API SceneRenderer {
 public:
+    // Views the editor shows, each drawn into its own pooled target
+    enum class View {
+        Editor,
+        Game,
+        Count
+    };
+
     /**
-     * @brief Create or resize scene framebuffer
-     * @param width Width of the framebuffer
-     * @param height Height of the framebuffer
-     * @return Framebuffer ID
+     * @brief Start a new editor frame: forget last frame's passes and hand their view targets back
      */
-    static unsigned int CreateSceneFramebuffer(int width, int height);
+    static void BeginFrame();
 
     /**
-     * @brief Delete the scene framebuffer and associated textures
+     * @brief Run the passes added this frame. Call before the UI showing the views is drawn
      */
-    static void DeleteSceneFramebuffer();
+    static void ExecuteFrame();
 
     /**
-     * @brief Get the scene color texture for display
-     * @return OpenGL texture ID
+     * @brief Release every pooled target and the editor camera
      */
-    static unsigned int GetSceneTexture();
+    static void Shutdown();
 
     /**
-     * @brief Begin rendering to scene framebuffer
-     * @param width Framebuffer width
-     * @param height Framebuffer height
+     * @brief Add a pass drawing the scene with the current game camera, at the dynamic
+     * resolution scale when enabled and upscaled to the view's size
+     * @param width Width of the view
+     * @param height Height of the view
+     * @param toBackbuffer Draw to the window instead of a pooled target
      */
-    static void BeginSceneRender(int width, int height);
+    static void AddGameViewPass(int width, int height, bool toBackbuffer = false);
 
     /**
-     * @brief End scene rendering (unbind framebuffer)
+     * @brief Add a pass drawing the scene with custom camera parameters
+     * @param width Width of the view
+     * @param height Height of the view
+     * @param cameraPos Camera position
+     * @param cameraFront Camera front vector
+     * @param cameraUp Camera up vector
+     * @param cameraZoom Camera zoom/FOV
      */
-    static void EndSceneRender();
+    static void AddEditorViewPass(int width, int height,
+                                  const glm::vec3& cameraPos,
+                                  const glm::vec3& cameraFront,
+                                  const glm::vec3& cameraUp,
+                                  float cameraZoom);
+
+    /**
+     * @brief Get a view's color texture for display, valid once its pass was added this frame
+     * @return OpenGL texture ID, 0 if the view wasn't added
+     */
+    static unsigned int GetViewTexture(View view);
+
+    /**
+     * @brief Part of the view texture the view covers. Pooled targets can be larger than
+     * the view, which is drawn into their bottom left corner
+     * @return Largest U and V of the view
+     */
+    static glm::vec2 GetViewUVScale(View view);
 
     /**
      * @brief Render the scene using the current game camera
@@ -82,12 +114,17 @@ public:
                                    float cameraZoom);
 
 private:
-    // Static framebuffer data
-    static unsigned int sceneFrameBuffer;
-    static unsigned int sceneColorTexture;
-    static unsigned int sceneDepthTexture;
-    static int sceneWidth;
-    static int sceneHeight;
+    struct ViewState {
+        RenderTarget* target = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Declares the view's passes: color is kept for the UI, depth and the scaled color are transient
+    static void AddViewPass(View view, int width, int height, bool toBackbuffer, std::function<void()> draw);
+
+    static FrameGraph frameGraph;
+    static ViewState views[static_cast<int>(View::Count)];
 
     // Static editor camera for rendering
     static Camera* editorCamera;
@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp> 
 #include "Asset Manager/Asset.hpp"
+#include "Graphics/UniformID.hpp"
 
 std::string get_file_contents(const char* filename);
 
@@ -21,6 +22,26 @@ public:
 	void Activate();
 	void Delete();
 
+	// Same shader compiled with INSTANCED defined, built alongside it in LoadAsset. Returns nullptr
+	// if the shader has no instanced path or the variant failed to compile
+	Shader* GetInstancedVariant() { return m_instancedVariant.get(); }
+
+    // Setters keyed by pre-hashed uniform ids (see Graphics/UniformID.hpp), used on the draw path
+    void setBool(UniformID id, GLboolean value);
+    void setInt(UniformID id, int value);
+    void setIntArray(UniformID id, const GLint* values, GLint count);
+    void setFloat(UniformID id, GLfloat value);
+    void setVec2(UniformID id, const glm::vec2& value);
+    void setVec2(UniformID id, float x, float y);
+    void setVec3(UniformID id, const glm::vec3& value);
+    void setVec3(UniformID id, float x, float y, float z);
+    void setVec4(UniformID id, const glm::vec4& value);
+    void setVec4(UniformID id, float x, float y, float z, float w);
+    void setMat2(UniformID id, const glm::mat2& mat);
+    void setMat3(UniformID id, const glm::mat3& mat);
+    void setMat4(UniformID id, const glm::mat4& mat);
+
+    // Name based setters, hash the name at runtime and forward to the id setters
     void setBool(const std::string& name, GLboolean value);
     void setInt(const std::string& name, int value);
     void setIntArray(const std::string& name, const GLint* values, GLint count);
@@ -35,9 +56,22 @@ public:
     void setMat3(const std::string& name, const glm::mat3& mat);
     void setMat4(const std::string& name, const glm::mat4& mat);
 
+    // Re-reads the active uniforms of the linked program
     void clearUniformCache();
 
 private:
-    std::unordered_map<std::string, GLint> m_uniformCache;
-    GLint getUniformLocation(const std::string& name);
+    std::unique_ptr<Shader> m_instancedVariant;
+
+    bool compileProgram(const std::string& vertexCode, const std::string& fragmentCode);
+    static std::string injectDefine(const std::string& source, const std::string& define);
+
+    struct UniformSlot {
+        uint32_t hash;
+        GLint location;
+    };
+
+    // Active uniforms sorted by name hash, built once after linking
+    std::vector<UniformSlot> m_uniformTable;
+    void resolveUniforms();
+    GLint getUniformLocation(UniformID id);
 };
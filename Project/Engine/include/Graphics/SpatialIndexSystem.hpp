@@ -0,0 +1,59 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ECS/System.hpp"
+#include "Graphics/DynamicAABBTree.hpp"
+#include "../Engine.h"  // For ENGINE_API macro
+
+class Model;
+
+struct SpatialRaycastHit {
+	Entity entity = 0;
+	float distance = 0.0f;
+	glm::vec3 point{ 0.0f };
+	bool hitTriangle = false;   // False when only the bounds were hit (entities without geometry)
+	uint32_t meshIndex = 0;
+	uint32_t triangleIndex = 0;
+};
+
+/**
+ * @brief Keeps every entity with a Transform in a dynamic AABB tree.
+ *
+ * Entities with a ModelRenderComponent use the model's bounds, everything else a unit
+ * cube around the transform. Update() refits only the entities whose transform or model
+ * changed. The renderer uses the frustum query to decide what to submit and the editor
+ * uses the ray query for click picking.
+ */
+class ENGINE_API SpatialIndexSystem : public System {
+public:
+	SpatialIndexSystem() = default;
+	~SpatialIndexSystem() = default;
+
+	void Update();
+	void Shutdown();
+
+	// Queries append the matching entities to out
+	void QueryFrustum(const Frustum& frustum, std::vector<Entity>& out) const;
+	void QueryAABB(const AABB& box, std::vector<Entity>& out) const;
+	void QuerySphere(const BoundingSphere& sphere, std::vector<Entity>& out) const;
+
+	// Closest entity hit within maxDistance. Models are tested against their triangles,
+	// other entities against their bounds. The direction is expected to be normalized
+	bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, SpatialRaycastHit& hit) const;
+
+	size_t GetEntityCount() const { return tree.GetProxyCount(); }
+
+private:
+	struct Record {
+		int32_t proxyId = DynamicAABBTree::NULL_NODE;
+		AABB worldBounds;           // Tight bounds, the tree stores a fattened copy
+		glm::mat4 transform{ 1.0f };
+		const Model* model = nullptr;
+		uint32_t updateStamp = 0;
+	};
+
+	DynamicAABBTree tree;
+	std::unordered_map<Entity, Record> records;
+	uint32_t updateStamp = 0;
+};
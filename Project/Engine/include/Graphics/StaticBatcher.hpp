@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ECS/Entity.hpp"
+#include "Graphics/Frustum.hpp"
+
+class ECSManager;
+class GraphicsManager;
+class Mesh;
+class Material;
+class Shader;
+
+/**
+ * @brief Merges the meshes of static entities into a few large world space meshes.
+ *
+ * Entities whose ModelRenderComponent is flagged isStatic have their meshes transformed
+ * into world space and appended to a batch per (spatial chunk, material, shader, render order).
+ * Each batch is an ordinary Mesh with its own bounds, so batches are still frustum culled.
+ * Transparent meshes and meshes without a material are left to the regular path.
+ */
+class StaticBatcher {
+public:
+	// Size of the cubic grid cells static geometry is grouped into
+	static constexpr float CHUNK_SIZE = 32.0f;
+
+	void Build(ECSManager& ecsManager, const std::set<Entity>& entities);
+	void Clear();
+
+	// True when a static entity was added, moved, destroyed or lost its static flag since the last build
+	bool NeedsRebuild(ECSManager& ecsManager, const std::set<Entity>& entities) const;
+
+	bool IsBatched(Entity entity) const { return batchedEntities.find(entity) != batchedEntities.end(); }
+
+	// Submits the batches that overlap the frustum, returns how many were submitted
+	size_t Submit(GraphicsManager& gfxManager, const Frustum& frustum) const;
+
+	size_t GetBatchCount() const { return batches.size(); }
+	size_t GetBatchedEntityCount() const { return batchedEntities.size(); }
+
+private:
+	struct Batch {
+		std::unique_ptr<Mesh> mesh;
+		std::shared_ptr<Shader> shader;
+		int renderOrder = 0;
+	};
+
+	std::vector<Batch> batches;
+	std::unordered_map<Entity, glm::mat4> batchedEntities; // Transform each entity was baked with
+};
@@ -3,41 +3,90 @@
 #include <glm/glm.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
-#include <map>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "Asset Manager/Asset.hpp"
-
-class VAO;
-class VBO;
+#include "Graphics/TextRendering/GlyphAtlas.hpp"
 
 struct Character {
-	unsigned int textureID;
+	glm::vec2 uvMin; // Atlas coordinates of the glyph's top-left corner
+	glm::vec2 uvMax;
 	glm::ivec2 size;
 	glm::ivec2 bearing;
 	unsigned int advance;
+	uint32_t page = GlyphAtlas::NO_PAGE; // Atlas layer, NO_PAGE for glyphs with nothing to draw
 };
 
 class Font : public IAsset {
 public:
-	Font(unsigned int defaultFontSize = 48);
+	// BITMAP rasterizes coverage at the font size. SDF stores signed distances at SDF_BASE_SIZE
+	// and scales them, so any size (or world space scale) stays sharp from one atlas
+	enum class GlyphMode {
+		BITMAP,
+		SDF
+	};
+
+	static constexpr unsigned int SDF_BASE_SIZE = 48;
+	static constexpr int SDF_SPREAD = 6; // Distance range in base size pixels on either side of the outline
+
+	// Glyphs are rasterized on first use into a fixed budget of atlas pages, least recently used pages are recycled
+	static constexpr int ATLAS_PAGE_SIZE = 1024;
+	static constexpr uint32_t ATLAS_PAGES = 4;
+
+	Font(unsigned int defaultFontSize = 48, GlyphMode mode = GlyphMode::SDF);
 	~Font();
 
 	bool LoadAsset(const std::string& path) override;
 	void Cleanup();
 	bool LoadFont(const std::string& path, unsigned int fontSize);
 
+	// Free in SDF mode, BITMAP mode reloads the glyphs
 	void SetFontSize(unsigned int newSize);
 	unsigned int GetFontSize() const { return fontSize; }
-	const Character& GetCharacter(char c) const;
-	float GetTextWidth(const std::string& text, float scale = 1.0f) const;
-	float GetTextHeight(float scale = 1.0f) const;
+	void SetGlyphMode(GlyphMode newMode);
+	GlyphMode GetGlyphMode() const { return glyphMode; }
+
+	// Character metrics are in rasterized pixels, multiply by this to get font size pixels
+	float GetGlyphScale() const { return glyphScale; }
+	// Rasterizes the glyph on first use. The copy stays valid after later glyphs evict its page
+	Character GetCharacter(uint32_t codepoint);
+	// Keeps the given atlas pages (bit per page) from being evicted this frame
+	void TouchPages(uint32_t pageMask);
+	float GetTextWidth(const std::string& text, float scale = 1.0f);
+	float GetTextHeight(float scale = 1.0f) const { return maxGlyphHeight * glyphScale * scale; }
+	// Baseline to baseline distance for multi-line text
+	float GetLineHeight(float scale = 1.0f) const { return lineHeight * glyphScale * scale; }
 
-	VAO* GetVAO() const { return textVAO.get(); }
-	VBO* GetVBO() const { return textVBO.get(); }
+	GLuint GetAtlasTexture() const { return atlas.GetTexture(); }
+	// Bumped every time glyphs are evicted or rescaled, so cached layouts know to rebuild
+	uint32_t GetGeneration() const { return generation; }
 private:
-	std::map<GLchar, Character> Characters;
-	std::unique_ptr<VAO> textVAO;
-	std::unique_ptr<VBO> textVBO;
+	// Open addressed codepoint -> glyph table, linear probing
+	struct GlyphSlot {
+		uint32_t codepoint = EMPTY_SLOT;
+		Character character;
+	};
+	static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+	GlyphSlot* FindGlyph(uint32_t codepoint);
+	void InsertGlyph(uint32_t codepoint, const Character& character);
+	void RebuildGlyphTable(size_t capacity, uint32_t droppedPage);
+	Character LoadGlyph(uint32_t codepoint);
+
+	std::vector<GlyphSlot> glyphTable;
+	size_t glyphCount = 0;
+	std::vector<unsigned char> glyphPixels;
+	GlyphAtlas atlas;
+	FT_Library library = nullptr;
+	FT_Face face = nullptr;
+	bool reportedFullAtlas = false;
+
+	float maxGlyphHeight = 0.0f;
+	float lineHeight = 0.0f;
+	float glyphScale = 1.0f;
+	uint32_t generation = 0;
 	unsigned int fontSize;
+	GlyphMode glyphMode;
 	std::string fontPath;
-};
\ No newline at end of file
+};
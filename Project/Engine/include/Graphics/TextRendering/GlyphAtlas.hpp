@@ -0,0 +1,76 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Fixed budget of single channel glyph pages, stored as layers of one texture array.
+ *
+ * Space on a page is handed out with a shelf packer: rectangles go on the shortest shelf they
+ * fit on, and a new shelf is opened below the last one when none does. When every page is full
+ * the least recently used page is cleared and reused, so glyphs are loaded on demand without
+ * the atlas ever growing. Pages drawn from since the last AdvanceFrame() are never evicted.
+ */
+class GlyphAtlas {
+public:
+	// Empty texels kept around every glyph so linear filtering doesn't pick up neighbours
+	static constexpr int PADDING = 1;
+	static constexpr uint32_t NO_PAGE = 0xFFFFFFFFu;
+
+	GlyphAtlas() = default;
+	~GlyphAtlas();
+
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+	// Called once per rendered view, pages touched before this become eligible for eviction
+	static void AdvanceFrame() { currentFrame++; }
+
+	// Clears the packer for pageCount pages of pageSize x pageSize texels and releases the texture
+	void Reset(int pageSize, uint32_t pageCount);
+
+	// Finds room for a width x height glyph. If a page had to be evicted for it, its index is
+	// returned in evictedPage (NO_PAGE otherwise). Returns false when nothing can be freed
+	bool Pack(int width, int height, glm::ivec2& position, uint32_t& page, uint32_t& evictedPage);
+
+	// Copies a tightly packed 8-bit bitmap into a page at position
+	void Upload(const glm::ivec2& position, uint32_t page, int width, int height, const unsigned char* pixels);
+
+	// Marks a page as drawn from this frame
+	void Touch(uint32_t page) { pages[page].lastUsedFrame = currentFrame; }
+
+	void Destroy();
+
+	GLuint GetTexture() const { return texture; }
+	int GetPageSize() const { return pageSize; }
+	uint32_t GetPageCount() const { return static_cast<uint32_t>(pages.size()); }
+
+	// Texture coordinate of a texel corner
+	glm::vec2 ToUV(const glm::ivec2& texel) const { return glm::vec2(texel) / static_cast<float>(pageSize); }
+
+private:
+	struct Shelf {
+		int y;
+		int height;
+		int nextX;
+	};
+
+	struct Page {
+		std::vector<Shelf> shelves;
+		int nextShelfY = 0;
+		uint64_t lastUsedFrame = 0;
+	};
+
+	bool PackOnPage(Page& page, int paddedWidth, int paddedHeight, glm::ivec2& position);
+	void CreateTexture();
+	void ClearPage(uint32_t page);
+
+	std::vector<Page> pages;
+	std::vector<unsigned char> clearPixels;     // One zeroed page, reused by ClearPage
+	uint32_t openPages = 0;
+	int pageSize = 0;
+	GLuint texture = 0;
+
+	inline static uint64_t currentFrame = 1;
+};
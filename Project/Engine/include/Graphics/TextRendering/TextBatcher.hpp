@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Graphics/VAO.h"
+#include "Graphics/VBO.h"
+
+class TextRenderComponent;
+
+struct TextVertex {
+	glm::vec3 position;
+	glm::vec3 texUV; // z is the atlas page
+	uint8_t color[4];
+};
+
+/**
+ * @brief Builds the glyph quads of every visible string into one streaming vertex buffer.
+ *
+ * Quads are transformed on the CPU (screen space for 2D text, world space for 3D text) and
+ * carry their own color, so any run of strings sharing a font atlas and shader can be drawn
+ * with a single glDrawArrays.
+ */
+class TextBatcher {
+public:
+	void Clear() { vertices.clear(); }
+	uint32_t GetVertexCount() const { return static_cast<uint32_t>(vertices.size()); }
+
+	// Appends the quads of item. Returns the number of vertices added
+	uint32_t Append(const TextRenderComponent& item);
+
+	// Streams this frame's vertices to the GPU
+	void Upload();
+	void Draw(uint32_t firstVertex, uint32_t vertexCount);
+
+	void Shutdown();
+
+private:
+	std::vector<TextVertex> vertices;
+	VAO textVAO;
+	std::unique_ptr<VBO> textVBO;
+	size_t capacity = 0;
+};
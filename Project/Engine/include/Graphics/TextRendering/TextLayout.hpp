@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Font;
+class TextRenderComponent;
+
+/**
+ * @brief Glyph quads of a text component, laid out once and reused until the text changes.
+ *
+ * Quads are in the component's local space (scale and alignment applied, position and
+ * transform not), so moving or recoloring a label never rebuilds it. Text is UTF-8, lines
+ * break on '\n' and are aligned individually.
+ */
+struct TextLayout {
+	struct Quad {
+		glm::vec2 min;      // Bottom-left corner
+		glm::vec2 max;
+		glm::vec2 uvMin;    // Atlas coordinates of the top-left corner
+		glm::vec2 uvMax;
+		float page;         // Atlas layer
+	};
+
+	std::vector<Quad> quads;
+	float width = 0.0f;     // Widest line
+	float height = 0.0f;
+	uint32_t lineCount = 0;
+	uint32_t pageMask = 0;  // Atlas pages the quads sample, bit per page
+
+	// True if the layout was built from the component's current text version and glyphs
+	bool IsCurrent(const TextRenderComponent& comp) const;
+	void Build(const TextRenderComponent& comp);
+
+private:
+	static constexpr uint32_t NOT_BUILT = 0xFFFFFFFFu;
+
+	uint32_t version = NOT_BUILT;
+	const Font* font = nullptr;
+	uint32_t fontGeneration = 0;
+};
@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 #include <glm/ext/matrix_transform.hpp>
 #include "Graphics/TextRendering/Font.hpp"
+#include "Graphics/TextRendering/TextLayout.hpp"
 
 class Shader;
 
@@ -27,6 +28,12 @@ public:
     };
     Alignment alignment = Alignment::LEFT;
 
+    // Bumped by the TextUtils setters that change the layout (text, scale, alignment).
+    // Bump it by hand after writing those members directly
+    uint32_t layoutVersion = 0;
+    // Built on first use, see TextUtils::GetLayout
+    mutable TextLayout layout;
+
     // Constructor with required parameters
     TextRenderComponent(const std::string& t, std::shared_ptr<Font> f, std::shared_ptr<Shader> s)
         : text(t), font(std::move(f)), shader(std::move(s)) {
@@ -44,7 +51,9 @@ public:
         scale(other.scale),
         is3D(other.is3D),
         transform(other.transform),
-        alignment(other.alignment) {
+        alignment(other.alignment),
+        layoutVersion(other.layoutVersion),
+        layout(other.layout) {
     }
 
     // Assignment operator
@@ -60,6 +69,8 @@ public:
             is3D = other.is3D;
             transform = other.transform;
             alignment = other.alignment;
+            layoutVersion = other.layoutVersion;
+            layout = other.layout;
         }
         return *this;
     }
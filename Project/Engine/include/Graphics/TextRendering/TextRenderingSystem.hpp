@@ -1,5 +1,6 @@
 #pragma once
 #include "ECS/System.hpp"
+#include "Graphics/RenderWorld.hpp"
 
 class TextRenderingSystem : public System {
 public:
@@ -7,6 +8,7 @@ public:
     ~TextRenderingSystem() = default;
 
     bool Initialise();
-    void Update();
+    // Gathers visible text into the frame's render world, drawn by reference from the components
+    void Extract(RenderWorld& world);
     void Shutdown();
 };
\ No newline at end of file
@@ -29,10 +29,16 @@ public:
     static void SetWorldPosition(TextRenderComponent& comp, const glm::vec3& worldPos);
     static void SetWorldPosition(TextRenderComponent& comp, float x, float y, float z);
 
+    // Cached glyph quads, rebuilt only when the layout version or font changed
+    static const TextLayout& GetLayout(const TextRenderComponent& comp);
+
     // Dimension calculations
     static float GetEstimatedWidth(const TextRenderComponent& comp);
     static float GetEstimatedHeight(const TextRenderComponent& comp);
 
+    // Decodes the UTF-8 sequence at index and moves index past it. Malformed bytes decode to U+FFFD one at a time
+    static uint32_t DecodeUTF8(const std::string& text, size_t& index);
+
     // Validation
     static bool IsValid(const TextRenderComponent& comp);
 
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Graphics/Bounds.hpp"
+
+class Mesh;
+
+struct TriangleRayHit {
+	float distance = 0.0f;
+	uint32_t meshIndex = 0;
+	uint32_t triangleIndex = 0;     // Index of the triangle within its mesh (indices / 3)
+	glm::vec2 barycentric{ 0.0f };  // Weights of the second and third vertex
+};
+
+/**
+ * @brief Static bounding volume hierarchy over a model's triangles.
+ *
+ * Built once from the CPU side vertex/index copies kept on each Mesh, using binned
+ * surface area heuristic splits. Triangles are stored in leaf order so a leaf is a
+ * contiguous range. Rays are traversed in model space, nearest child first.
+ */
+class TriangleBVH {
+public:
+	void Build(const std::vector<Mesh>& meshes);
+	void Clear();
+
+	// Closest triangle hit within maxDistance. The direction does not need to be normalized,
+	// distance is returned in units of the direction's length
+	bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleRayHit& hit) const;
+
+	bool Empty() const { return nodes.empty(); }
+	size_t GetTriangleCount() const { return triangles.size(); }
+	size_t GetNodeCount() const { return nodes.size(); }
+
+private:
+	struct Triangle {
+		glm::vec3 v0;
+		glm::vec3 edge1;            // v1 - v0
+		glm::vec3 edge2;            // v2 - v0
+		uint32_t meshIndex;
+		uint32_t triangleIndex;
+	};
+
+	struct Node {
+		AABB box;
+		uint32_t first = 0;         // First triangle for leaves, left child for interior nodes (right = left + 1)
+		uint32_t count = 0;         // Triangle count, 0 for interior nodes
+
+		bool IsLeaf() const { return count > 0; }
+	};
+
+	static constexpr uint32_t MAX_LEAF_TRIANGLES = 4;
+	static constexpr int BIN_COUNT = 12;
+
+	void Subdivide(uint32_t nodeIndex, std::vector<uint32_t>& order, const std::vector<AABB>& triangleBounds, const std::vector<glm::vec3>& centroids);
+
+	static bool IntersectTriangle(const Triangle& triangle, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& distance, glm::vec2& barycentric);
+
+	std::vector<Triangle> triangles;
+	std::vector<Node> nodes;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "OpenGL.h"
+
+struct LightSet;
+struct FrameView;
+
+// Binding points shared by every shader that declares the matching uniform block
+namespace UniformBlockBinding {
+	constexpr GLuint CAMERA = 0;
+	constexpr GLuint LIGHTS = 1;
+}
+
+// The block structs mirror the std140 layouts declared in the shaders. Everything is
+// padded out to vec4 so the C++ and GLSL layouts match without relying on vec3 packing.
+struct CameraBlock {
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::mat4 viewProjection;
+	glm::vec4 cameraPosition;   // xyz = position
+};
+
+struct DirectionalLightBlock {
+	glm::vec4 direction;
+	glm::vec4 ambient;
+	glm::vec4 diffuse;
+	glm::vec4 specular;
+};
+
+// Point and spot lights live in the cluster textures (see ClusteredLighting.hpp), the block
+// only carries what a fragment needs to find its cluster
+struct LightBlock {
+	DirectionalLightBlock dirLight;
+	glm::vec4 clusterScale;     // xy = clusters per pixel, z = slices per log depth, w = slice offset
+	glm::ivec4 clusterDims;     // xyz = cluster grid size, w = clustered light count
+};
+
+static_assert(sizeof(CameraBlock) == 208, "CameraBlock must match the std140 CameraData block");
+static_assert(sizeof(LightBlock) == 96, "LightBlock must match the std140 LightData block");
+
+// Owns the per-frame uniform buffers. They are filled once per rendered view and stay bound to
+// their binding points, so draws only upload per-object data (model matrix and material).
+class UniformBuffers {
+public:
+	static UniformBuffers& GetInstance();
+
+	void Shutdown();
+
+	void UpdateCamera(const FrameView& frameView);
+	void UpdateLights(const LightSet& lightSet, const FrameView& frameView);
+
+	// Connects the program's CameraData/LightData blocks to the shared binding points, call after linking
+	static void BindShaderBlocks(GLuint program);
+
+private:
+	UniformBuffers() = default;
+	~UniformBuffers() = default;
+
+	UniformBuffers(const UniformBuffers&) = delete;
+	UniformBuffers& operator=(const UniformBuffers&) = delete;
+
+	// Buffers are created on first use since they need a live GL context
+	void EnsureCreated();
+	void Upload(GLuint buffer, const void* data, GLsizeiptr size);
+
+	GLuint cameraUBO = 0;
+	GLuint lightUBO = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+// Identifies a shader uniform by the FNV-1a hash of its name. Constants declared below are hashed
+// at compile time, so setting a uniform through them does no string work at runtime.
+struct UniformID {
+	uint32_t hash = 0;
+	const char* name = nullptr; // Only used for diagnostics, not guaranteed to outlive the call
+
+	static constexpr uint32_t Hash(std::string_view str)
+	{
+		uint32_t value = 2166136261u;
+		for (char c : str)
+		{
+			value ^= static_cast<uint8_t>(c);
+			value *= 16777619u;
+		}
+		return value;
+	}
+
+	constexpr explicit UniformID(std::string_view str) : hash(Hash(str)), name(str.data()) {}
+	constexpr explicit UniformID(const char* str) : UniformID(std::string_view(str)) {}
+};
+
+namespace Uniforms {
+	// Transforms
+	inline constexpr UniformID Model{ "model" };
+	inline constexpr UniformID View{ "view" };
+	inline constexpr UniformID Projection{ "projection" };
+	inline constexpr UniformID CameraPos{ "cameraPos" };
+
+	// Packed vertex position decode (see VertexFormat.hpp)
+	inline constexpr UniformID PositionOffset{ "positionOffset" };
+	inline constexpr UniformID PositionScale{ "positionScale" };
+
+	// Material properties
+	inline constexpr UniformID MaterialAmbient{ "material.ambient" };
+	inline constexpr UniformID MaterialDiffuse{ "material.diffuse" };
+	inline constexpr UniformID MaterialSpecular{ "material.specular" };
+	inline constexpr UniformID MaterialEmissive{ "material.emissive" };
+	inline constexpr UniformID MaterialShininess{ "material.shininess" };
+	inline constexpr UniformID MaterialOpacity{ "material.opacity" };
+
+	// Material texture flags
+	inline constexpr UniformID MaterialHasDiffuseMap{ "material.hasDiffuseMap" };
+	inline constexpr UniformID MaterialHasSpecularMap{ "material.hasSpecularMap" };
+	inline constexpr UniformID MaterialHasNormalMap{ "material.hasNormalMap" };
+	inline constexpr UniformID MaterialHasEmissiveMap{ "material.hasEmissiveMap" };
+
+	// Material samplers
+	inline constexpr UniformID MaterialDiffuseMap{ "material.diffuseMap" };
+	inline constexpr UniformID MaterialSpecularMap{ "material.specularMap" };
+	inline constexpr UniformID MaterialNormalMap{ "material.normalMap" };
+	inline constexpr UniformID MaterialHeightMap{ "material.heightMap" };
+	inline constexpr UniformID MaterialAOMap{ "material.aoMap" };
+	inline constexpr UniformID MaterialMetallicMap{ "material.metallicMap" };
+	inline constexpr UniformID MaterialRoughnessMap{ "material.roughnessMap" };
+	inline constexpr UniformID MaterialEmissiveMap{ "material.emissiveMap" };
+
+	// Text
+	inline constexpr UniformID TextDistanceField{ "distanceField" };
+}
@@ -3,10 +3,10 @@
 #include <glm/glm.hpp>
 #include <vector>
 
+// CPU side vertex, meshes are packed into PackedVertex (VertexFormat.hpp) when uploaded
 struct Vertex {
 	glm::vec3 position;
 	glm::vec3 normal;
-	glm::vec3 color;
 	glm::vec2 texUV;
 };
 
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Graphics/Bounds.hpp"
+#include "VBO.h"
+
+// GPU side vertex, 16 bytes instead of the 32 byte CPU Vertex:
+//   position - unorm16 x3, quantized within the mesh bounds (decoded with positionOffset/positionScale)
+//   normal   - snorm16 x2, octahedral encoded
+//   texUV    - half float x2
+struct PackedVertex {
+	uint16_t position[4];   // w is padding
+	int16_t normal[2];
+	uint16_t texUV[2];
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay tightly packed");
+
+// Maps quantized positions back to model space: position = offset + quantized * scale
+struct PositionDecode {
+	glm::vec3 offset{ 0.0f };
+	glm::vec3 scale{ 1.0f };
+
+	static PositionDecode FromBounds(const AABB& bounds);
+};
+
+namespace VertexFormat {
+	glm::vec2 EncodeOctahedral(const glm::vec3& normal);
+	glm::vec3 DecodeOctahedral(const glm::vec2& encoded);
+
+	PackedVertex Pack(const Vertex& vertex, const PositionDecode& decode);
+}
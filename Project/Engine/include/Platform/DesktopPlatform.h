@@ -46,6 +46,7 @@ public:
     
     bool InitializeGraphics() override;
     void MakeContextCurrent() override;
+    void ReleaseContext() override;
     
     void* GetNativeWindow() override;
     
@@ -37,6 +37,8 @@ public:
     // OpenGL context
     virtual bool InitializeGraphics() = 0;
     virtual void MakeContextCurrent() = 0;
+    // Detaches the context from the calling thread so another thread can make it current
+    virtual void ReleaseContext() = 0;
     
     // Window state management methods already declared above
     
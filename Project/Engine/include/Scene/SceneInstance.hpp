@@ -17,6 +17,9 @@ public:
 	void Exit() override;
 	void processInput(float deltaTime); // temp function
 
+	// Gathers renderables into the frame's render world, only the first view drawn each frame does the work
+	void ExtractRenderWorld();
+
 	void DrawLightCubes();
 	void DrawLightCubes(const Camera& cameraOverride);
 
@@ -31,40 +34,40 @@ public:
 
 	std::vector<Vertex> lightVertices = {
 		// Back face (4 vertices: 0-3)
-		{{-0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 0
-		{{ 0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 1
-		{{ 0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 2
-		{{-0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 3
+		{{-0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 0
+		{{ 0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 1
+		{{ 0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 2
+		{{-0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 3
 
 		// Front face (4 vertices: 4-7)
-		{{-0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 4
-		{{ 0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 5
-		{{ 0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 6
-		{{-0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 7
+		{{-0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 4
+		{{ 0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 5
+		{{ 0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 6
+		{{-0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 7
 
 		// Left face (4 vertices: 8-11)
-		{{-0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 8
-		{{-0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 9
-		{{-0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 10
-		{{-0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 11
+		{{-0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 8
+		{{-0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 9
+		{{-0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 10
+		{{-0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 11
 
 		// Right face (4 vertices: 12-15)
-		{{ 0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 12
-		{{ 0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 13
-		{{ 0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 14
-		{{ 0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 15
+		{{ 0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 12
+		{{ 0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 13
+		{{ 0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 14
+		{{ 0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 15
 
 		// Bottom face (4 vertices: 16-19)
-		{{-0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 16
-		{{ 0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 17
-		{{ 0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 18
-		{{-0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 19
+		{{-0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 16
+		{{ 0.1f, -0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 17
+		{{ 0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 18
+		{{-0.1f, -0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 19
 
 		// Top face (4 vertices: 20-23)
-		{{-0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 20
-		{{ 0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 21
-		{{ 0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}, // 22
-		{{-0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f}}  // 23
+		{{-0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 20
+		{{ 0.1f,  0.1f, -0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 21
+		{{ 0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}, // 22
+		{{-0.1f,  0.1f,  0.1f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}}  // 23
 	};
 
 	std::vector<GLuint> lightIndices = {
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed pool of worker threads for data parallel loops.
+ *
+ * ParallelFor splits [0, count) into ranges of rangeSize and hands them out to the workers and
+ * the calling thread, returning once every range has run. Ranges are numbered, so jobs can
+ * write into per-range output slots and the caller can merge them in a deterministic order.
+ * Jobs must not touch the GL context, it stays on the thread that created it.
+ */
+class JobSystem {
+public:
+	// Signature of one range: [begin, end) and the range's index
+	using RangeJob = std::function<void(uint32_t begin, uint32_t end, uint32_t rangeIndex)>;
+
+	static JobSystem& GetInstance();
+
+	// workerCount 0 uses one worker per hardware thread besides the caller's
+	void Initialize(uint32_t workerCount = 0);
+	void Shutdown();
+
+	uint32_t GetWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+	static uint32_t GetRangeCount(uint32_t count, uint32_t rangeSize) { return (count + rangeSize - 1) / rangeSize; }
+
+	// Runs job over every range and blocks until all have finished. Runs inline when there are
+	// no workers, only one range, or when called from inside another job
+	void ParallelFor(uint32_t count, uint32_t rangeSize, const RangeJob& job);
+
+private:
+	JobSystem() = default;
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// One ParallelFor call. Workers hold on to it by shared_ptr, so one that wakes late only
+	// ever finds an exhausted loop instead of claiming ranges of the next one
+	struct Loop {
+		const RangeJob* job = nullptr;
+		uint32_t count = 0;
+		uint32_t rangeSize = 1;
+		uint32_t rangeCount = 0;
+		std::atomic<uint32_t> nextRange{ 0 };
+		std::atomic<uint32_t> pendingRanges{ 0 };
+	};
+
+	void WorkerLoop();
+	// Claims and runs ranges of loop until none are left
+	void RunRanges(Loop& loop);
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable doneCondition;
+	std::mutex submitMutex;                 // One loop in flight at a time
+	bool stopping = false;
+	uint64_t loopGeneration = 0;
+	std::shared_ptr<Loop> currentLoop;
+
+	inline static thread_local bool insideJob = false;
+};
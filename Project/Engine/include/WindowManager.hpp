@@ -36,6 +36,10 @@ public:
     static void SwapBuffers();
     static void PollEvents();
 
+    // Moves the GL context between threads, see RenderThread
+    static void MakeContextCurrent();
+    static void ReleaseContext();
+
     static void error_cb(int error, char const* description);
     static void fbsize_cb(PlatformWindow ptr_win, int width, int height);
 
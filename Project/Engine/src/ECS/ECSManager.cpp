@@ -27,6 +27,13 @@ void ECSManager::Initialize() {
 		SetSystemSignature<TransformSystem>(signature);
 	}
 
+	spatialIndexSystem = RegisterSystem<SpatialIndexSystem>();
+	{
+		Signature signature;
+		signature.set(GetComponentID<Transform>());
+		SetSystemSignature<SpatialIndexSystem>(signature);
+	}
+
 	modelSystem = RegisterSystem<ModelSystem>();
 	{
 		Signature signature;
@@ -3,6 +3,13 @@
 #include "Graphics/OpenGL.h"
 #include "Platform/Platform.h"
 #include "Graphics/LightManager.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/RenderStats.hpp"
+#include "Threading/JobSystem.hpp"
+#include "Graphics/RenderThread.hpp"
+#include "Graphics/GraphicsManager.hpp"
+#include "Graphics/SceneRenderer.hpp"
+#include "Graphics/DynamicResolution.hpp"
 
 #include "Engine.h"
 #include "Logging.hpp"
@@ -20,6 +27,7 @@ namespace TEMP {
 
 // Static member definition
 GameState Engine::currentGameState = GameState::EDIT_MODE;
+bool Engine::threadedRendering = false;
 
 const unsigned int SCR_WIDTH = 1600;
 const unsigned int SCR_HEIGHT = 900;
@@ -38,6 +46,10 @@ bool Engine::Initialize() {
 		return false;
 	}
 	SetGameState(GameState::PLAY_MODE);
+
+	// Worker threads for parallel render extraction
+	JobSystem::GetInstance().Initialize();
+
 	WindowManager::Initialize(SCR_WIDTH, SCR_HEIGHT, TEMP::windowTitle.c_str());
 
     ENGINE_LOG_INFO("Engine initializing...");
@@ -301,15 +313,41 @@ void Engine::Update() {
 }
 
 void Engine::StartDraw() {
+	// Every view drawn until the next StartDraw shares one render world
+	GraphicsManager::GetInstance().NewFrame();
+	DynamicResolution::GetInstance().Update();
+
+	RenderThread& renderThread = RenderThread::GetInstance();
+
+	// Started on the first frame so scene setup before it still runs on the main thread's context
+	if (threadedRendering && !renderThread.IsRunning()) {
+		renderThread.Start();
+	}
+
+	// The render thread begins its own frames
+	if (!renderThread.IsRunning()) {
+		GLStateCache::GetInstance().BeginFrame();
+		RenderStats::GetInstance().BeginFrame();
+	}
 }
 
 void Engine::Draw() {
+	// The scaled view and its upscale need the context, which the render thread holds while running
+	if (DynamicResolution::GetInstance().IsEnabled() && !RenderThread::GetInstance().IsRunning()) {
+		SceneRenderer::BeginFrame();
+		SceneRenderer::AddGameViewPass(WindowManager::GetWindowWidth(), WindowManager::GetWindowHeight(), true);
+		SceneRenderer::ExecuteFrame();
+		return;
+	}
+
 	SceneManager::GetInstance().DrawScene();
-	
 }
 
 void Engine::EndDraw() {
-	WindowManager::SwapBuffers();
+	// The render thread presents once it has drawn the frame
+	if (!RenderThread::GetInstance().IsRunning()) {
+		WindowManager::SwapBuffers();
+	}
 
 	// Only process input if the game should be running (not paused)
 	if (ShouldRunGameLogic()) {
@@ -321,7 +359,10 @@ void Engine::EndDraw() {
 
 void Engine::Shutdown() {
 	ENGINE_LOG_INFO("Engine shutdown started");
+	RenderThread::GetInstance().Stop();
+	SceneRenderer::Shutdown();
 	AudioManager::StaticShutdown();
+	JobSystem::GetInstance().Shutdown();
     EngineLogging::Shutdown();
     std::cout << "[Engine] Shutdown complete" << std::endl;
 }
@@ -330,6 +371,10 @@ bool Engine::IsRunning() {
 	return !WindowManager::ShouldClose();
 }
 
+void Engine::SetThreadedRendering(bool enabled) {
+	threadedRendering = enabled;
+}
+
 // Game state management functions
 void Engine::SetGameState(GameState state) {
 	currentGameState = state;
@@ -0,0 +1,385 @@
+#include "pch.h"
+#include "Graphics/ClusteredLighting.hpp"
+#include "Graphics/FrameView.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/LightManager.hpp"
+#include "Graphics/RenderStats.hpp"
+
+namespace {
+	constexpr float POINT_LIGHT = 0.0f;
+	constexpr float SPOT_LIGHT = 1.0f;
+
+	void CreateListTexture(GLuint& texture, GLuint unit)
+	{
+		glGenTextures(1, &texture);
+		GLStateCache::GetInstance().BindTexture(unit, texture);
+
+		// Integer and float lists are read with texelFetch, they must never be filtered
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	void DeleteListTexture(GLuint& texture)
+	{
+		if (texture != 0)
+		{
+			glDeleteTextures(1, &texture);
+			GLStateCache::GetInstance().OnTextureDeleted(texture);
+			texture = 0;
+		}
+	}
+}
+
+ClusteredLighting& ClusteredLighting::GetInstance()
+{
+	static ClusteredLighting instance;
+	return instance;
+}
+
+void ClusteredLighting::Shutdown()
+{
+	DeleteListTexture(lightTexture);
+	DeleteListTexture(gridTexture);
+	DeleteListTexture(indexTexture);
+}
+
+void ClusteredLighting::Update(const LightSet& lightSet, const FrameView& frameView)
+{
+	GatherLights(lightSet, frameView);
+	BuildClusterBounds(frameView);
+	AssignLights(frameView);
+	UploadTextures();
+}
+
+glm::vec2 ClusteredLighting::GetSliceScale(const FrameView& frameView)
+{
+	float logDepthRange = std::log(frameView.farPlane / frameView.nearPlane);
+	float scale = static_cast<float>(GRID_Z) / logDepthRange;
+	return glm::vec2(scale, -std::log(frameView.nearPlane) * scale);
+}
+
+void ClusteredLighting::BindShaderSamplers(GLuint program)
+{
+	GLint lightData = glGetUniformLocation(program, "clusterLightData");
+	GLint clusterGrid = glGetUniformLocation(program, "clusterGrid");
+	GLint lightIndexList = glGetUniformLocation(program, "clusterLightIndices");
+	if (lightData == -1 && clusterGrid == -1 && lightIndexList == -1)
+	{
+		return;
+	}
+
+	// Sampler units are program state, so they only need setting once
+	GLStateCache::GetInstance().UseProgram(program);
+	if (lightData != -1)
+	{
+		glUniform1i(lightData, ClusterTextureUnit::LIGHT_DATA);
+	}
+	if (clusterGrid != -1)
+	{
+		glUniform1i(clusterGrid, ClusterTextureUnit::CLUSTER_GRID);
+	}
+	if (lightIndexList != -1)
+	{
+		glUniform1i(lightIndexList, ClusterTextureUnit::LIGHT_INDICES);
+	}
+}
+
+float ClusteredLighting::ComputeRange(const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, float constant, float linear, float quadratic, float maxRange)
+{
+	glm::vec3 brightest = glm::max(ambient, glm::max(diffuse, specular));
+	float intensity = std::max(brightest.r, std::max(brightest.g, brightest.b));
+
+	// Distance where intensity / (constant + linear * d + quadratic * d^2) drops to the cutoff
+	float target = intensity / INTENSITY_CUTOFF;
+	if (target <= constant)
+	{
+		return 0.0f;
+	}
+
+	float range = maxRange;
+	if (quadratic > 0.0f)
+	{
+		range = (-linear + std::sqrt(linear * linear - 4.0f * quadratic * (constant - target))) / (2.0f * quadratic);
+	}
+	else if (linear > 0.0f)
+	{
+		range = (target - constant) / linear;
+	}
+	return std::min(range, maxRange);
+}
+
+void ClusteredLighting::GatherLights(const LightSet& lightSet, const FrameView& frameView)
+{
+	lights.clear();
+	viewSpheres.clear();
+
+	// A light can still reach a visible surface from up to a far plane's distance outside the view
+	const float maxRange = frameView.farPlane * 2.0f;
+	bool overflowed = false;
+
+	auto addLight = [&](const ClusterLight& light, const glm::vec3& boundCenter, float boundRadius)
+	{
+		if (lights.size() >= MAX_LIGHTS)
+		{
+			overflowed = true;
+			return;
+		}
+		lights.push_back(light);
+		viewSpheres.push_back(glm::vec4(glm::vec3(frameView.view * glm::vec4(boundCenter, 1.0f)), boundRadius));
+	};
+
+	for (const PointLight& pointLight : lightSet.pointLights)
+	{
+		float range = ComputeRange(pointLight.ambient, pointLight.diffuse, pointLight.specular, pointLight.constant, pointLight.linear, pointLight.quadratic, maxRange);
+		if (range <= 0.0f)
+		{
+			continue;
+		}
+
+		ClusterLight light{};
+		light.positionRange = glm::vec4(pointLight.position, range);
+		light.ambient = glm::vec4(pointLight.ambient, POINT_LIGHT);
+		light.diffuse = glm::vec4(pointLight.diffuse, 0.0f);
+		light.specular = glm::vec4(pointLight.specular, 0.0f);
+		light.attenuation = glm::vec4(pointLight.constant, pointLight.linear, pointLight.quadratic, 0.0f);
+		addLight(light, pointLight.position, range);
+	}
+
+	// The spotlight acts as a flashlight attached to the rendering camera
+	if (lightSet.spotLightEnabled)
+	{
+		const SpotLight& spotLight = lightSet.spotLight;
+		float range = ComputeRange(spotLight.ambient, spotLight.diffuse, spotLight.specular, spotLight.constant, spotLight.linear, spotLight.quadratic, maxRange);
+		if (range > 0.0f)
+		{
+			ClusterLight light{};
+			light.positionRange = glm::vec4(frameView.cameraPosition, range);
+			light.ambient = glm::vec4(spotLight.ambient, SPOT_LIGHT);
+			light.diffuse = glm::vec4(spotLight.diffuse, 0.0f);
+			light.specular = glm::vec4(spotLight.specular, 0.0f);
+			light.attenuation = glm::vec4(spotLight.constant, spotLight.linear, spotLight.quadratic, spotLight.outerCutOff);
+			light.direction = glm::vec4(frameView.cameraFront, spotLight.cutOff);
+
+			// Smallest sphere around the cone, wide cones are bounded by their cap, narrow ones by their length
+			float cosAngle = glm::clamp(spotLight.outerCutOff, 0.01f, 1.0f);
+			glm::vec3 center;
+			float radius;
+			if (cosAngle < 0.70710678f)
+			{
+				center = frameView.cameraPosition + frameView.cameraFront * (range * cosAngle);
+				radius = range * std::sqrt(1.0f - cosAngle * cosAngle);
+			}
+			else
+			{
+				radius = range / (2.0f * cosAngle);
+				center = frameView.cameraPosition + frameView.cameraFront * radius;
+			}
+			addLight(light, center, radius);
+		}
+	}
+
+	if (overflowed && !reportedOverflow)
+	{
+		std::cerr << "[ClusteredLighting] More than " << MAX_LIGHTS << " lights, the rest are ignored" << std::endl;
+		reportedOverflow = true;
+	}
+}
+
+void ClusteredLighting::BuildClusterBounds(const FrameView& frameView)
+{
+	// Cluster shapes only depend on the projection, so they survive camera movement
+	if (!clusterBounds.empty() && frameView.projection == boundsProjection)
+	{
+		return;
+	}
+	boundsProjection = frameView.projection;
+	clusterBounds.resize(CLUSTER_COUNT);
+
+	const glm::mat4& projection = frameView.projection;
+	const float depthRatio = frameView.farPlane / frameView.nearPlane;
+
+	// View space x of a point at distance depth that projects to ndcX, likewise for y
+	auto viewX = [&](float ndcX, float depth) { return (ndcX + projection[2][0]) * depth / projection[0][0]; };
+	auto viewY = [&](float ndcY, float depth) { return (ndcY + projection[2][1]) * depth / projection[1][1]; };
+
+	for (int z = 0; z < GRID_Z; z++)
+	{
+		float nearDepth = frameView.nearPlane * std::pow(depthRatio, static_cast<float>(z) / GRID_Z);
+		float farDepth = frameView.nearPlane * std::pow(depthRatio, static_cast<float>(z + 1) / GRID_Z);
+
+		for (int y = 0; y < GRID_Y; y++)
+		{
+			float ndcY0 = -1.0f + 2.0f * y / GRID_Y;
+			float ndcY1 = -1.0f + 2.0f * (y + 1) / GRID_Y;
+
+			for (int x = 0; x < GRID_X; x++)
+			{
+				float ndcX0 = -1.0f + 2.0f * x / GRID_X;
+				float ndcX1 = -1.0f + 2.0f * (x + 1) / GRID_X;
+
+				// A froxel widens with depth, so its extremes are on the near and far faces
+				float xs[4] = { viewX(ndcX0, nearDepth), viewX(ndcX1, nearDepth), viewX(ndcX0, farDepth), viewX(ndcX1, farDepth) };
+				float ys[4] = { viewY(ndcY0, nearDepth), viewY(ndcY1, nearDepth), viewY(ndcY0, farDepth), viewY(ndcY1, farDepth) };
+
+				ClusterBounds& bounds = clusterBounds[x + y * GRID_X + z * GRID_X * GRID_Y];
+				bounds.min = glm::vec3(*std::min_element(xs, xs + 4), *std::min_element(ys, ys + 4), -farDepth);
+				bounds.max = glm::vec3(*std::max_element(xs, xs + 4), *std::max_element(ys, ys + 4), -nearDepth);
+			}
+		}
+	}
+}
+
+void ClusteredLighting::AssignLights(const FrameView& frameView)
+{
+	pairs.clear();
+	clusterCounts.assign(CLUSTER_COUNT, 0);
+
+	const glm::mat4& projection = frameView.projection;
+	const glm::vec2 sliceScale = GetSliceScale(frameView);
+	auto sliceOf = [&](float depth)
+	{
+		int slice = static_cast<int>(std::floor(std::log(depth) * sliceScale.x + sliceScale.y));
+		return glm::clamp(slice, 0, GRID_Z - 1);
+	};
+	auto tileOf = [](float ndc, int tiles)
+	{
+		return glm::clamp(static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * tiles)), 0, tiles - 1);
+	};
+
+	bool overflowed = false;
+	for (uint32_t lightIndex = 0; lightIndex < viewSpheres.size() && !overflowed; lightIndex++)
+	{
+		const glm::vec3 center = glm::vec3(viewSpheres[lightIndex]);
+		const float radius = viewSpheres[lightIndex].w;
+		const float depth = -center.z;
+
+		if (depth + radius < frameView.nearPlane || depth - radius > frameView.farPlane)
+		{
+			continue;
+		}
+
+		int z0 = sliceOf(std::max(depth - radius, frameView.nearPlane));
+		int z1 = sliceOf(std::min(depth + radius, frameView.farPlane));
+
+		// Conservative screen rectangle from the corners of the sphere's view space box.
+		// Spheres reaching the near plane can project anywhere, so they get every tile
+		int x0 = 0, x1 = GRID_X - 1, y0 = 0, y1 = GRID_Y - 1;
+		if (depth - radius > frameView.nearPlane)
+		{
+			glm::vec2 ndcMin(std::numeric_limits<float>::max());
+			glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+			for (float cornerDepth : { depth - radius, depth + radius })
+			{
+				for (float dx : { -radius, radius })
+				{
+					float ndcX = projection[0][0] * (center.x + dx) / cornerDepth - projection[2][0];
+					ndcMin.x = std::min(ndcMin.x, ndcX);
+					ndcMax.x = std::max(ndcMax.x, ndcX);
+				}
+				for (float dy : { -radius, radius })
+				{
+					float ndcY = projection[1][1] * (center.y + dy) / cornerDepth - projection[2][1];
+					ndcMin.y = std::min(ndcMin.y, ndcY);
+					ndcMax.y = std::max(ndcMax.y, ndcY);
+				}
+			}
+
+			if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+			{
+				continue;
+			}
+			x0 = tileOf(ndcMin.x, GRID_X);
+			x1 = tileOf(ndcMax.x, GRID_X);
+			y0 = tileOf(ndcMin.y, GRID_Y);
+			y1 = tileOf(ndcMax.y, GRID_Y);
+		}
+
+		// Refine with an exact sphere vs cluster box test
+		for (int z = z0; z <= z1 && !overflowed; z++)
+		{
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					uint32_t cluster = x + y * GRID_X + z * GRID_X * GRID_Y;
+					const ClusterBounds& bounds = clusterBounds[cluster];
+					glm::vec3 offset = center - glm::clamp(center, bounds.min, bounds.max);
+					if (glm::dot(offset, offset) > radius * radius)
+					{
+						continue;
+					}
+
+					if (pairs.size() >= MAX_LIGHT_INDICES)
+					{
+						overflowed = true;
+						break;
+					}
+					pairs.push_back(cluster << 16 | lightIndex);
+					clusterCounts[cluster]++;
+				}
+			}
+		}
+	}
+
+	if (overflowed && !reportedOverflow)
+	{
+		std::cerr << "[ClusteredLighting] Cluster light lists are full, some lights are dropped" << std::endl;
+		reportedOverflow = true;
+	}
+
+	// Counting sort the pairs into one contiguous index list per cluster
+	clusterGrid.resize(CLUSTER_COUNT * 2);
+	uint32_t offset = 0;
+	for (uint32_t cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+	{
+		clusterGrid[cluster * 2] = offset;
+		clusterGrid[cluster * 2 + 1] = 0;
+		offset += clusterCounts[cluster];
+	}
+
+	lightIndices.resize(pairs.size());
+	for (uint32_t pair : pairs)
+	{
+		uint32_t cluster = pair >> 16;
+		lightIndices[clusterGrid[cluster * 2] + clusterGrid[cluster * 2 + 1]++] = pair & 0xFFFFu;
+	}
+}
+
+void ClusteredLighting::UploadTextures()
+{
+	if (lightTexture == 0)
+	{
+		CreateListTexture(lightTexture, ClusterTextureUnit::LIGHT_DATA);
+		CreateListTexture(gridTexture, ClusterTextureUnit::CLUSTER_GRID);
+		CreateListTexture(indexTexture, ClusterTextureUnit::LIGHT_INDICES);
+	}
+
+	GLStateCache& stateCache = GLStateCache::GetInstance();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// Each texture is respecified rather than updated in place, so draws from the previous
+	// view that still read the old lists don't stall the upload
+	// A single row is only as wide as the lights in it, more than that are padded out to whole rows
+	const size_t lightCount = lights.size();
+	GLsizei lightColumns = static_cast<GLsizei>(std::clamp<size_t>(lightCount, 1, LIGHTS_PER_ROW));
+	GLsizei lightRows = static_cast<GLsizei>(std::max<size_t>((lightCount + LIGHTS_PER_ROW - 1) / LIGHTS_PER_ROW, 1));
+	lights.resize(static_cast<size_t>(lightColumns) * lightRows);
+	stateCache.BindTexture(ClusterTextureUnit::LIGHT_DATA, lightTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, LIGHT_TEXELS * lightColumns, lightRows, 0, GL_RGBA, GL_FLOAT, lights.data());
+	lights.resize(lightCount);
+
+	stateCache.BindTexture(ClusterTextureUnit::CLUSTER_GRID, gridTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, GRID_X * GRID_Y, GRID_Z, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, clusterGrid.data());
+
+	// Pad the index list out to whole rows
+	GLsizei indexRows = static_cast<GLsizei>(std::max<size_t>((lightIndices.size() + INDEX_TEXTURE_WIDTH - 1) / INDEX_TEXTURE_WIDTH, 1));
+	lightIndices.resize(static_cast<size_t>(indexRows) * INDEX_TEXTURE_WIDTH, 0);
+	stateCache.BindTexture(ClusterTextureUnit::LIGHT_INDICES, indexTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, INDEX_TEXTURE_WIDTH, indexRows, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, lightIndices.data());
+	RENDER_STATS_ADD(bufferUploadBytes, static_cast<uint64_t>(lightColumns) * lightRows * sizeof(ClusterLight)
+		+ static_cast<uint64_t>(CLUSTER_COUNT) * 2 * sizeof(GLuint)
+		+ lightIndices.size() * sizeof(GLuint));
+	lightIndices.resize(pairs.size());
+}
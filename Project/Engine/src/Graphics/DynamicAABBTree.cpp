@@ -0,0 +1,327 @@
+#include "pch.h"
+#include "Graphics/DynamicAABBTree.hpp"
+
+DynamicAABBTree::DynamicAABBTree(float fatMargin) : margin(fatMargin)
+{
+}
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& box, uint32_t userData)
+{
+	int32_t proxyId = AllocateNode();
+
+	const glm::vec3 fat(margin);
+	nodes[proxyId].box = AABB(box.min - fat, box.max + fat);
+	nodes[proxyId].userData = userData;
+	nodes[proxyId].height = 0;
+
+	InsertLeaf(proxyId);
+	proxyCount++;
+	return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyId)
+{
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	proxyCount--;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& box)
+{
+	if (Contains(nodes[proxyId].box, box))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+
+	const glm::vec3 fat(margin);
+	nodes[proxyId].box = AABB(box.min - fat, box.max + fat);
+
+	InsertLeaf(proxyId);
+	return true;
+}
+
+void DynamicAABBTree::Clear()
+{
+	nodes.clear();
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+	proxyCount = 0;
+}
+
+bool DynamicAABBTree::RayIntersectsAABB(const glm::vec3& origin, const glm::vec3& invDirection, const AABB& box, float maxDistance, float& distance)
+{
+	glm::vec3 t1 = (box.min - origin) * invDirection;
+	glm::vec3 t2 = (box.max - origin) * invDirection;
+
+	glm::vec3 tMin = glm::min(t1, t2);
+	glm::vec3 tMax = glm::max(t1, t2);
+
+	float tNear = std::max(std::max(tMin.x, tMin.y), tMin.z);
+	float tFar = std::min(std::min(tMax.x, tMax.y), tMax.z);
+
+	if (tNear > tFar || tFar < 0.0f || tNear > maxDistance)
+	{
+		return false;
+	}
+
+	distance = std::max(tNear, 0.0f);
+	return true;
+}
+
+int32_t DynamicAABBTree::AllocateNode()
+{
+	if (freeList == NULL_NODE)
+	{
+		nodes.emplace_back();
+		return static_cast<int32_t>(nodes.size() - 1);
+	}
+
+	int32_t nodeId = freeList;
+	freeList = nodes[nodeId].parent;
+	nodes[nodeId] = Node();
+	return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int32_t nodeId)
+{
+	nodes[nodeId].parent = freeList;
+	nodes[nodeId].child1 = NULL_NODE;
+	nodes[nodeId].child2 = NULL_NODE;
+	nodes[nodeId].height = -1;
+	freeList = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf)
+{
+	if (root == NULL_NODE)
+	{
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Walk down towards the sibling that is cheapest to pair with (surface area heuristic)
+	const AABB leafBox = nodes[leaf].box;
+	int32_t index = root;
+	while (!nodes[index].IsLeaf())
+	{
+		int32_t child1 = nodes[index].child1;
+		int32_t child2 = nodes[index].child2;
+
+		float area = SurfaceArea(nodes[index].box);
+		float combinedArea = SurfaceArea(Combine(nodes[index].box, leafBox));
+
+		// Cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](int32_t child) {
+			float newArea = SurfaceArea(Combine(leafBox, nodes[child].box));
+			if (nodes[child].IsLeaf())
+			{
+				return newArea + inheritanceCost;
+			}
+			return (newArea - SurfaceArea(nodes[child].box)) + inheritanceCost;
+		};
+
+		float cost1 = descendCost(child1);
+		float cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int32_t sibling = index;
+
+	// Create a new parent for the sibling and the leaf
+	int32_t oldParent = nodes[sibling].parent;
+	int32_t newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].box = Combine(leafBox, nodes[sibling].box);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (nodes[oldParent].child1 == sibling)
+		{
+			nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		root = newParent;
+	}
+
+	// Refit and rebalance the ancestors
+	index = nodes[leaf].parent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		int32_t child1 = nodes[index].child1;
+		int32_t child2 = nodes[index].child2;
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+		nodes[index].box = Combine(nodes[child1].box, nodes[child2].box);
+
+		index = nodes[index].parent;
+	}
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+{
+	if (leaf == root)
+	{
+		root = NULL_NODE;
+		return;
+	}
+
+	int32_t parent = nodes[leaf].parent;
+	int32_t grandParent = nodes[parent].parent;
+	int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent == NULL_NODE)
+	{
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		FreeNode(parent);
+		return;
+	}
+
+	// Replace the parent with the sibling and refit upwards
+	if (nodes[grandParent].child1 == parent)
+	{
+		nodes[grandParent].child1 = sibling;
+	}
+	else
+	{
+		nodes[grandParent].child2 = sibling;
+	}
+	nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	int32_t index = grandParent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		int32_t child1 = nodes[index].child1;
+		int32_t child2 = nodes[index].child2;
+		nodes[index].box = Combine(nodes[child1].box, nodes[child2].box);
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+
+		index = nodes[index].parent;
+	}
+}
+
+int32_t DynamicAABBTree::Balance(int32_t iA)
+{
+	// Rotates the taller grandchild up when the subtrees of A differ in height by more than one
+	Node& A = nodes[iA];
+	if (A.IsLeaf() || A.height < 2)
+	{
+		return iA;
+	}
+
+	int32_t iB = A.child1;
+	int32_t iC = A.child2;
+	int32_t balance = nodes[iC].height - nodes[iB].height;
+
+	auto rotateUp = [&](int32_t iHigh, int32_t iLow, bool highIsChild2) {
+		Node& high = nodes[iHigh];
+		int32_t iF = high.child1;
+		int32_t iG = high.child2;
+
+		// Swap A and the taller child
+		high.child1 = iA;
+		high.parent = nodes[iA].parent;
+		nodes[iA].parent = iHigh;
+
+		if (high.parent != NULL_NODE)
+		{
+			if (nodes[high.parent].child1 == iA)
+			{
+				nodes[high.parent].child1 = iHigh;
+			}
+			else
+			{
+				nodes[high.parent].child2 = iHigh;
+			}
+		}
+		else
+		{
+			root = iHigh;
+		}
+
+		// Keep the taller grandchild under the promoted node, hand the other to A
+		int32_t iKeep = nodes[iF].height > nodes[iG].height ? iF : iG;
+		int32_t iGive = iKeep == iF ? iG : iF;
+
+		high.child2 = iKeep;
+		if (highIsChild2)
+		{
+			nodes[iA].child2 = iGive;
+		}
+		else
+		{
+			nodes[iA].child1 = iGive;
+		}
+		nodes[iGive].parent = iA;
+
+		nodes[iA].box = Combine(nodes[iLow].box, nodes[iGive].box);
+		nodes[iA].height = 1 + std::max(nodes[iLow].height, nodes[iGive].height);
+		high.box = Combine(nodes[iA].box, nodes[iKeep].box);
+		high.height = 1 + std::max(nodes[iA].height, nodes[iKeep].height);
+
+		return iHigh;
+	};
+
+	if (balance > 1)
+	{
+		return rotateUp(iC, iB, true);
+	}
+	if (balance < -1)
+	{
+		return rotateUp(iB, iC, false);
+	}
+	return iA;
+}
+
+AABB DynamicAABBTree::Combine(const AABB& a, const AABB& b)
+{
+	return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+}
+
+float DynamicAABBTree::SurfaceArea(const AABB& box)
+{
+	glm::vec3 size = box.max - box.min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool DynamicAABBTree::Contains(const AABB& outer, const AABB& inner)
+{
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+		&& inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+bool DynamicAABBTree::Overlaps(const AABB& a, const AABB& b)
+{
+	return a.min.x <= b.max.x && b.min.x <= a.max.x
+		&& a.min.y <= b.max.y && b.min.y <= a.max.y
+		&& a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
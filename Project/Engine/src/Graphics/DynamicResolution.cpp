@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "Graphics/DynamicResolution.hpp"
+
+DynamicResolution& DynamicResolution::GetInstance()
+{
+	static DynamicResolution instance;
+	return instance;
+}
+
+DynamicResolution::DynamicResolution()
+{
+#ifdef ANDROID
+	// Phones throttle under sustained load, holding the frame rate matters more than sharpness there
+	settings.enabled = true;
+#endif
+}
+
+void DynamicResolution::Update()
+{
+	auto now = std::chrono::steady_clock::now();
+	if (hasLastFrameTime)
+	{
+		cpuFrameMs = std::chrono::duration<double, std::milli>(now - lastFrameTime).count();
+	}
+	lastFrameTime = now;
+	hasLastFrameTime = true;
+
+	if (!settings.enabled)
+	{
+		return;
+	}
+
+	// The bounds may have been changed from the editor
+	SetScale(scale);
+
+	// GPU times only cover the scaled pass, so they're the better signal once they arrive
+	const bool useGpu = gpuTimingsValid;
+	if (useGpu && !gpuTimingUpdated)
+	{
+		return;
+	}
+	gpuTimingUpdated = false;
+
+	const double frameMs = useGpu ? gpuFrameMs : cpuFrameMs;
+	smoothedMs = smoothedMs <= 0.0 ? frameMs : smoothedMs + (frameMs - smoothedMs) * SMOOTHING;
+
+	if (cooldown > 0)
+	{
+		cooldown--;
+		return;
+	}
+
+	const double targetMs = 1000.0 / std::max(settings.targetFps, 1.0f);
+	if (smoothedMs > targetMs)
+	{
+		// Cost follows the pixel count, so the scale goes with the square root of the time
+		framesOnTarget = 0;
+		float desired = scale * static_cast<float>(std::sqrt(targetMs * BUDGET_HEADROOM / smoothedMs));
+		float stepped = std::floor(desired / SCALE_STEP) * SCALE_STEP;
+		SetScale(std::min(stepped, scale - SCALE_STEP));
+		return;
+	}
+
+	if (useGpu)
+	{
+		if (smoothedMs < targetMs * SCALE_UP_THRESHOLD)
+		{
+			SetScale(scale + SCALE_STEP);
+		}
+	}
+	else if (++framesOnTarget >= PROBE_FRAMES)
+	{
+		framesOnTarget = 0;
+		SetScale(scale + SCALE_STEP);
+	}
+}
+
+void DynamicResolution::Shutdown()
+{
+#ifdef DYNAMIC_RESOLUTION_GPU_TIMER
+	if (queries[0] != 0)
+	{
+		if (queryActive)
+		{
+			glEndQuery(GL_TIME_ELAPSED);
+		}
+		glDeleteQueries(QUERY_COUNT, queries);
+	}
+#endif
+	for (uint32_t i = 0; i < QUERY_COUNT; i++)
+	{
+		queries[i] = 0;
+		queryPending[i] = false;
+	}
+	queryActive = false;
+	gpuTimingsValid = false;
+}
+
+void DynamicResolution::BeginGpuTimer()
+{
+#ifdef DYNAMIC_RESOLUTION_GPU_TIMER
+	if (queries[0] == 0)
+	{
+		glGenQueries(QUERY_COUNT, queries);
+	}
+	ReadGpuTimers();
+
+	// Every query is still waiting on the GPU, this pass goes untimed
+	if (queryActive || queryPending[nextQuery])
+	{
+		return;
+	}
+	glBeginQuery(GL_TIME_ELAPSED, queries[nextQuery]);
+	queryActive = true;
+#endif
+}
+
+void DynamicResolution::EndGpuTimer()
+{
+#ifdef DYNAMIC_RESOLUTION_GPU_TIMER
+	if (!queryActive)
+	{
+		return;
+	}
+	glEndQuery(GL_TIME_ELAPSED);
+	queryPending[nextQuery] = true;
+	nextQuery = (nextQuery + 1) % QUERY_COUNT;
+	queryActive = false;
+#endif
+}
+
+void DynamicResolution::ReadGpuTimers()
+{
+#ifdef DYNAMIC_RESOLUTION_GPU_TIMER
+	// Oldest first, later queries can't finish before it
+	for (uint32_t i = 0; i < QUERY_COUNT; i++)
+	{
+		uint32_t query = (nextQuery + i) % QUERY_COUNT;
+		if (!queryPending[query])
+		{
+			continue;
+		}
+
+		GLint available = 0;
+		glGetQueryObjectiv(queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			break;
+		}
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(queries[query], GL_QUERY_RESULT, &elapsed);
+		queryPending[query] = false;
+		gpuFrameMs = static_cast<double>(elapsed) / 1000000.0;
+		gpuTimingsValid = true;
+		gpuTimingUpdated = true;
+	}
+#endif
+}
+
+void DynamicResolution::SetScale(float newScale)
+{
+	float minScale = std::clamp(settings.minScale, SCALE_STEP, 1.0f);
+	float maxScale = std::clamp(settings.maxScale, minScale, 1.0f);
+	newScale = std::clamp(newScale, minScale, maxScale);
+
+	if (std::abs(newScale - scale) < SCALE_STEP * 0.5f)
+	{
+		return;
+	}
+
+	// Timings from before the change no longer apply
+	scale = newScale;
+	smoothedMs = 0.0;
+	cooldown = COOLDOWN_FRAMES;
+}
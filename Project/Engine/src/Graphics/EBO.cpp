@@ -1,12 +1,14 @@
 #include "pch.h"
 
 #include "Graphics/EBO.h"
+#include "Graphics/RenderStats.hpp"
 
 EBO::EBO(std::vector<GLuint>& indices)
 {
 	glGenBuffers(1, &ID);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	RENDER_STATS_ADD(bufferUploadBytes, indices.size() * sizeof(GLuint));
 }
 
 void EBO::Bind()
@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "Graphics/FrameGraph.hpp"
+
+FrameGraph::Resource FrameGraph::Create(const std::string& name, const RenderTargetDesc& desc)
+{
+	ResourceNode& node = resources.emplace_back();
+	node.name = name;
+	node.desc = desc;
+	return static_cast<Resource>(resources.size() - 1);
+}
+
+FrameGraph::Resource FrameGraph::Import(const std::string& name, RenderTarget* target)
+{
+	ResourceNode& node = resources.emplace_back();
+	node.name = name;
+	node.target = target;
+	node.imported = true;
+	if (target)
+	{
+		node.desc = RenderTargetDesc{ target->width, target->height, target->format };
+	}
+	return static_cast<Resource>(resources.size() - 1);
+}
+
+void FrameGraph::AddPass(const std::string& name, std::vector<Resource> reads, std::vector<Resource> writes, ExecuteFunction execute)
+{
+	PassNode& pass = passes.emplace_back();
+	pass.name = name;
+	pass.reads = std::move(reads);
+	pass.writes = std::move(writes);
+	pass.execute = std::move(execute);
+}
+
+void FrameGraph::Compile()
+{
+	const uint32_t passCount = static_cast<uint32_t>(passes.size());
+
+	for (uint32_t passIndex = 0; passIndex < passCount; passIndex++)
+	{
+		PassNode& pass = passes[passIndex];
+		pass.refCount = static_cast<uint32_t>(pass.writes.size());
+		for (Resource resource : pass.reads)
+		{
+			resources[resource].refCount++;
+		}
+		for (Resource resource : pass.writes)
+		{
+			resources[resource].writers.push_back(passIndex);
+		}
+	}
+
+	// Results nobody reads are dropped, along with the passes that only produce those
+	std::vector<Resource> unused;
+	for (Resource resource = 0; resource < resources.size(); resource++)
+	{
+		ResourceNode& node = resources[resource];
+		if (node.imported)
+		{
+			node.refCount++;
+		}
+		if (node.refCount == 0)
+		{
+			unused.push_back(resource);
+		}
+	}
+
+	while (!unused.empty())
+	{
+		Resource resource = unused.back();
+		unused.pop_back();
+
+		for (uint32_t writer : resources[resource].writers)
+		{
+			PassNode& pass = passes[writer];
+			if (pass.refCount == 0 || --pass.refCount > 0)
+			{
+				continue;
+			}
+			for (Resource read : pass.reads)
+			{
+				if (--resources[read].refCount == 0)
+				{
+					unused.push_back(read);
+				}
+			}
+		}
+	}
+
+	// Transient targets live from their first use to their last one
+	for (uint32_t passIndex = 0; passIndex < passCount; passIndex++)
+	{
+		PassNode& pass = passes[passIndex];
+		if (pass.refCount == 0)
+		{
+			continue;
+		}
+
+		auto use = [&](Resource resource)
+		{
+			ResourceNode& node = resources[resource];
+			if (node.firstPass == NO_PASS)
+			{
+				node.firstPass = passIndex;
+			}
+			node.lastPass = passIndex;
+		};
+		for (Resource resource : pass.reads)
+		{
+			use(resource);
+		}
+		for (Resource resource : pass.writes)
+		{
+			use(resource);
+		}
+	}
+
+	for (Resource resource = 0; resource < resources.size(); resource++)
+	{
+		const ResourceNode& node = resources[resource];
+		if (node.imported || node.firstPass == NO_PASS)
+		{
+			continue;
+		}
+		passes[node.firstPass].acquires.push_back(resource);
+		passes[node.lastPass].releases.push_back(resource);
+	}
+}
+
+void FrameGraph::Execute()
+{
+	Compile();
+
+	RenderTargetPool& pool = RenderTargetPool::GetInstance();
+	executedPassCount = 0;
+
+	for (PassNode& pass : passes)
+	{
+		if (pass.refCount == 0)
+		{
+			continue;
+		}
+
+		for (Resource resource : pass.acquires)
+		{
+			resources[resource].target = pool.Acquire(resources[resource].desc);
+		}
+
+		if (pass.execute)
+		{
+			pass.execute(*this);
+		}
+		executedPassCount++;
+
+		// Handed back right away, so later passes in this frame can reuse the memory
+		for (Resource resource : pass.releases)
+		{
+			pool.Release(resources[resource].target);
+			resources[resource].target = nullptr;
+		}
+	}
+
+	Clear();
+}
+
+void FrameGraph::Clear()
+{
+	resources.clear();
+	passes.clear();
+}
+
+RenderTarget* FrameGraph::GetTarget(Resource resource) const
+{
+	return resource < resources.size() ? resources[resource].target : nullptr;
+}
+
+GLuint FrameGraph::GetFramebuffer(Resource color, Resource depth) const
+{
+	return RenderTargetPool::GetInstance().GetFramebuffer(GetTarget(color), GetTarget(depth));
+}
@@ -0,0 +1,29 @@
+#include "pch.h"
+#include "Graphics/FrameView.hpp"
+#include "Graphics/Camera.h"
+
+FrameView FrameView::Build(const Camera& camera, int viewportWidth, int viewportHeight, float nearPlane, float farPlane)
+{
+	FrameView frameView;
+
+	// Prevent division by zero and ensure minimum dimensions
+	frameView.viewportWidth = viewportWidth > 0 ? viewportWidth : 1;
+	frameView.viewportHeight = viewportHeight > 0 ? viewportHeight : 1;
+	frameView.nearPlane = nearPlane;
+	frameView.farPlane = farPlane;
+
+	float aspectRatio = (float)frameView.viewportWidth / (float)frameView.viewportHeight;
+
+	// Clamp aspect ratio to reasonable bounds to prevent assertion errors
+	if (aspectRatio < 0.001f) aspectRatio = 0.001f;
+	if (aspectRatio > 1000.0f) aspectRatio = 1000.0f;
+
+	frameView.view = camera.GetViewMatrix();
+	frameView.projection = glm::perspective(glm::radians(camera.Zoom), aspectRatio, nearPlane, farPlane);
+	frameView.viewProjection = frameView.projection * frameView.view;
+	frameView.frustum = Frustum::FromMatrix(frameView.viewProjection);
+	frameView.cameraPosition = camera.Position;
+	frameView.cameraFront = camera.Front;
+
+	return frameView;
+}
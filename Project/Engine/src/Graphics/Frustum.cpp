@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "Graphics/Frustum.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define FRUSTUM_USE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define FRUSTUM_USE_NEON 1
+#endif
+
+Frustum Frustum::FromMatrix(const glm::mat4& m)
+{
+	// glm is column-major, so row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+	glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+	glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+	glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+	glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	Frustum frustum;
+	frustum.planes[PLANE_LEFT] = row3 + row0;
+	frustum.planes[PLANE_RIGHT] = row3 - row0;
+	frustum.planes[PLANE_BOTTOM] = row3 + row1;
+	frustum.planes[PLANE_TOP] = row3 - row1;
+	frustum.planes[PLANE_NEAR] = row3 + row2;
+	frustum.planes[PLANE_FAR] = row3 - row2;
+
+	// Normalize so plane distances are in world units and can be compared against radii
+	for (glm::vec4& plane : frustum.planes)
+	{
+		float length = glm::length(glm::vec3(plane));
+		if (length > 0.0f)
+		{
+			plane /= length;
+		}
+	}
+
+	return frustum;
+}
+
+bool Frustum::IntersectsSphere(const BoundingSphere& sphere) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::IntersectsAABB(const AABB& box) const
+{
+	if (!box.IsValid())
+	{
+		return false;
+	}
+
+	for (const glm::vec4& plane : planes)
+	{
+		// Corner furthest along the plane normal; if even that is behind the plane the box is outside
+		glm::vec3 positive(
+			plane.x >= 0.0f ? box.max.x : box.min.x,
+			plane.y >= 0.0f ? box.max.y : box.min.y,
+			plane.z >= 0.0f ? box.max.z : box.min.z);
+
+		if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void Frustum::TestSpheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t count, uint8_t* outVisible) const
+{
+	size_t i = 0;
+
+#if defined(FRUSTUM_USE_SSE)
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(centerX + i);
+		__m128 y = _mm_loadu_ps(centerY + i);
+		__m128 z = _mm_loadu_ps(centerZ + i);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+		for (const glm::vec4& plane : planes)
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+				_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		outVisible[i + 0] = static_cast<uint8_t>((mask >> 0) & 1);
+		outVisible[i + 1] = static_cast<uint8_t>((mask >> 1) & 1);
+		outVisible[i + 2] = static_cast<uint8_t>((mask >> 2) & 1);
+		outVisible[i + 3] = static_cast<uint8_t>((mask >> 3) & 1);
+	}
+#elif defined(FRUSTUM_USE_NEON)
+	for (; i + 4 <= count; i += 4)
+	{
+		float32x4_t x = vld1q_f32(centerX + i);
+		float32x4_t y = vld1q_f32(centerY + i);
+		float32x4_t z = vld1q_f32(centerZ + i);
+		float32x4_t negRadius = vnegq_f32(vld1q_f32(radius + i));
+		uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+
+		for (const glm::vec4& plane : planes)
+		{
+			float32x4_t distance = vdupq_n_f32(plane.w);
+			distance = vmlaq_n_f32(distance, x, plane.x);
+			distance = vmlaq_n_f32(distance, y, plane.y);
+			distance = vmlaq_n_f32(distance, z, plane.z);
+			inside = vandq_u32(inside, vcgeq_f32(distance, negRadius));
+		}
+
+		outVisible[i + 0] = static_cast<uint8_t>(vgetq_lane_u32(inside, 0) & 1u);
+		outVisible[i + 1] = static_cast<uint8_t>(vgetq_lane_u32(inside, 1) & 1u);
+		outVisible[i + 2] = static_cast<uint8_t>(vgetq_lane_u32(inside, 2) & 1u);
+		outVisible[i + 3] = static_cast<uint8_t>(vgetq_lane_u32(inside, 3) & 1u);
+	}
+#endif
+
+	// Scalar path for the remainder, or everything on targets without SIMD
+	for (; i < count; i++)
+	{
+		outVisible[i] = IntersectsSphere(BoundingSphere(glm::vec3(centerX[i], centerY[i], centerZ[i]), radius[i])) ? 1 : 0;
+	}
+}
@@ -0,0 +1,187 @@
+#include "pch.h"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/RenderStats.hpp"
+
+GLStateCache& GLStateCache::GetInstance()
+{
+	static GLStateCache instance;
+	return instance;
+}
+
+GLStateCache::GLStateCache()
+{
+	Invalidate();
+}
+
+void GLStateCache::BeginFrame()
+{
+	lastFrameStats = currentStats;
+	currentStats = Stats{};
+	Invalidate();
+}
+
+void GLStateCache::Invalidate()
+{
+	program = UNKNOWN_NAME;
+	vertexArray = UNKNOWN_NAME;
+	activeUnit = UNKNOWN_NAME;
+	for (GLuint& texture : boundTextures)
+	{
+		texture = UNKNOWN_NAME;
+	}
+
+	blend = -1;
+	depthTest = -1;
+	depthWrite = -1;
+	cullFace = -1;
+	blendSrc = UNKNOWN_ENUM;
+	blendDst = UNKNOWN_ENUM;
+}
+
+void GLStateCache::UseProgram(GLuint newProgram)
+{
+	if (program == newProgram)
+	{
+		currentStats.skipped++;
+		return;
+	}
+
+	glUseProgram(newProgram);
+	program = newProgram;
+	currentStats.issued++;
+	RENDER_STATS_ADD(programBinds, 1);
+}
+
+void GLStateCache::BindVertexArray(GLuint vao)
+{
+	if (vertexArray == vao)
+	{
+		currentStats.skipped++;
+		return;
+	}
+
+	glBindVertexArray(vao);
+	vertexArray = vao;
+	currentStats.issued++;
+}
+
+void GLStateCache::BindTexture(GLuint unit, GLuint texture, GLenum target)
+{
+	if (unit >= MAX_TEXTURE_UNITS)
+	{
+		std::cerr << "[GLStateCache] Texture unit " << unit << " exceeds the tracked unit count" << std::endl;
+		return;
+	}
+
+	if (boundTextures[unit] == texture)
+	{
+		currentStats.skipped++;
+		return;
+	}
+
+	if (activeUnit != unit)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		activeUnit = unit;
+		currentStats.issued++;
+	}
+
+	glBindTexture(target, texture);
+	boundTextures[unit] = texture;
+	currentStats.issued++;
+	RENDER_STATS_ADD(textureBinds, 1);
+}
+
+void GLStateCache::SetBlend(bool enabled)
+{
+	SetCapability(blend, GL_BLEND, enabled);
+}
+
+void GLStateCache::SetBlendFunc(GLenum srcFactor, GLenum dstFactor)
+{
+	if (blendSrc == srcFactor && blendDst == dstFactor)
+	{
+		currentStats.skipped++;
+		return;
+	}
+
+	glBlendFunc(srcFactor, dstFactor);
+	blendSrc = srcFactor;
+	blendDst = dstFactor;
+	currentStats.issued++;
+}
+
+void GLStateCache::SetDepthTest(bool enabled)
+{
+	SetCapability(depthTest, GL_DEPTH_TEST, enabled);
+}
+
+void GLStateCache::SetDepthWrite(bool enabled)
+{
+	int8_t value = enabled ? 1 : 0;
+	if (depthWrite == value)
+	{
+		currentStats.skipped++;
+		return;
+	}
+
+	glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	depthWrite = value;
+	currentStats.issued++;
+}
+
+void GLStateCache::SetCullFace(bool enabled)
+{
+	SetCapability(cullFace, GL_CULL_FACE, enabled);
+}
+
+void GLStateCache::SetCapability(int8_t& shadow, GLenum capability, bool enabled)
+{
+	int8_t value = enabled ? 1 : 0;
+	if (shadow == value)
+	{
+		currentStats.skipped++;
+		return;
+	}
+
+	if (enabled)
+	{
+		glEnable(capability);
+	}
+	else
+	{
+		glDisable(capability);
+	}
+	shadow = value;
+	currentStats.issued++;
+}
+
+void GLStateCache::OnProgramDeleted(GLuint deletedProgram)
+{
+	// Deleting the current program leaves it in use until another is bound, so force the next bind
+	if (program == deletedProgram)
+	{
+		program = UNKNOWN_NAME;
+	}
+}
+
+void GLStateCache::OnVertexArrayDeleted(GLuint vao)
+{
+	// GL reverts the binding to zero when the bound VAO is deleted
+	if (vertexArray == vao)
+	{
+		vertexArray = 0;
+	}
+}
+
+void GLStateCache::OnTextureDeleted(GLuint texture)
+{
+	// GL reverts any unit the texture was bound to back to zero
+	for (GLuint& bound : boundTextures)
+	{
+		if (bound == texture)
+		{
+			bound = 0;
+		}
+	}
+}
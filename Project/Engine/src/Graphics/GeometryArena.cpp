@@ -0,0 +1,315 @@
+#include "pch.h"
+#include "Graphics/GeometryArena.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/RenderStats.hpp"
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : capacity(capacity)
+{
+	if (capacity > 0)
+	{
+		freeBlocks.emplace(0, capacity);
+	}
+}
+
+uint32_t RangeAllocator::Allocate(uint32_t size)
+{
+	for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+	{
+		if (it->second < size)
+		{
+			continue;
+		}
+
+		uint32_t offset = it->first;
+		uint32_t remaining = it->second - size;
+		freeBlocks.erase(it);
+		if (remaining > 0)
+		{
+			freeBlocks.emplace(offset + size, remaining);
+		}
+		used += size;
+		return offset;
+	}
+	return INVALID_OFFSET;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+	used -= size;
+
+	auto it = freeBlocks.emplace(offset, size).first;
+
+	// Merge with the following block
+	auto next = std::next(it);
+	if (next != freeBlocks.end() && it->first + it->second == next->first)
+	{
+		it->second += next->second;
+		freeBlocks.erase(next);
+	}
+
+	// Merge with the preceding block
+	if (it != freeBlocks.begin())
+	{
+		auto previous = std::prev(it);
+		if (previous->first + previous->second == it->first)
+		{
+			previous->second += it->second;
+			freeBlocks.erase(it);
+		}
+	}
+}
+
+GeometryArena& GeometryArena::GetInstance()
+{
+	static GeometryArena instance;
+	return instance;
+}
+
+GeometryAllocation GeometryArena::Allocate(const std::vector<PackedVertex>& vertices, const std::vector<GLuint>& indices)
+{
+	GeometryAllocation allocation;
+	if (vertices.empty() || indices.empty())
+	{
+		return allocation;
+	}
+
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	const uint32_t indexCount = static_cast<uint32_t>(indices.size());
+
+	// Ranges whose largest index fits in 16 bits use 16-bit indices. With rebasing that depends on
+	// where the vertices land in the page. Index ranges are allocated in 4-byte words either way,
+	// so two 16-bit indices share a word and every range stays aligned for both index types
+	auto usesShortIndices = [vertexCount](uint32_t vertexOffset) {
+#ifdef GEOMETRY_ARENA_REBASE_INDICES
+		return static_cast<uint64_t>(vertexOffset) + vertexCount <= 0x10000u;
+#else
+		(void)vertexOffset;
+		return vertexCount <= 0x10000u;
+#endif
+	};
+	auto indexWordsFor = [indexCount](bool shortIndices) {
+		return shortIndices ? (indexCount + 1) / 2 : indexCount;
+	};
+
+	// First page with room for both ranges
+	uint32_t pageIndex = GeometryAllocation::INVALID_PAGE;
+	uint32_t vertexOffset = RangeAllocator::INVALID_OFFSET;
+	uint32_t indexOffset = RangeAllocator::INVALID_OFFSET;
+	bool shortIndices = false;
+	uint32_t indexWords = 0;
+	for (uint32_t i = 0; i < pages.size(); i++)
+	{
+		vertexOffset = pages[i].vertices.Allocate(vertexCount);
+		if (vertexOffset == RangeAllocator::INVALID_OFFSET)
+		{
+			continue;
+		}
+
+		shortIndices = usesShortIndices(vertexOffset);
+		indexWords = indexWordsFor(shortIndices);
+		indexOffset = pages[i].indices.Allocate(indexWords);
+		if (indexOffset == RangeAllocator::INVALID_OFFSET)
+		{
+			pages[i].vertices.Free(vertexOffset, vertexCount);
+			continue;
+		}
+
+		pageIndex = i;
+		break;
+	}
+
+	if (pageIndex == GeometryAllocation::INVALID_PAGE)
+	{
+		// Meshes bigger than a page get a page of their own
+		shortIndices = usesShortIndices(0);
+		indexWords = indexWordsFor(shortIndices);
+		pageIndex = CreatePage(std::max(VERTICES_PER_PAGE, vertexCount), std::max(INDEX_WORDS_PER_PAGE, indexWords));
+		vertexOffset = pages[pageIndex].vertices.Allocate(vertexCount);
+		indexOffset = pages[pageIndex].indices.Allocate(indexWords);
+	}
+
+	Page& page = pages[pageIndex];
+	page.allocationCount++;
+
+	glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+	glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(vertexOffset) * sizeof(PackedVertex), vertexCount * sizeof(PackedVertex), vertices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	RENDER_STATS_ADD(bufferUploadBytes, vertexCount * sizeof(PackedVertex));
+
+	// The element buffer binding is VAO state, so upload through the page's VAO
+	BindPage(page);
+#ifdef GEOMETRY_ARENA_REBASE_INDICES
+	const GLuint indexBase = vertexOffset;
+#else
+	const GLuint indexBase = 0;
+#endif
+	const GLintptr indexByteOffset = static_cast<GLintptr>(indexOffset) * sizeof(GLuint);
+	if (shortIndices)
+	{
+		indices16.resize(static_cast<size_t>(indexWords) * 2);
+		for (uint32_t i = 0; i < indexCount; i++)
+		{
+			indices16[i] = static_cast<uint16_t>(indices[i] + indexBase);
+		}
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexByteOffset, indexCount * sizeof(uint16_t), indices16.data());
+	}
+	else if (indexBase != 0)
+	{
+		indices32.resize(indexCount);
+		for (uint32_t i = 0; i < indexCount; i++)
+		{
+			indices32[i] = indices[i] + indexBase;
+		}
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexByteOffset, indexCount * sizeof(GLuint), indices32.data());
+	}
+	else
+	{
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexByteOffset, indexCount * sizeof(GLuint), indices.data());
+	}
+	RENDER_STATS_ADD(bufferUploadBytes, indexCount * (shortIndices ? sizeof(uint16_t) : sizeof(GLuint)));
+
+	allocation.page = pageIndex;
+	allocation.vertexOffset = vertexOffset;
+	allocation.vertexCount = vertexCount;
+	allocation.indexOffset = indexOffset;
+	allocation.indexWords = indexWords;
+	allocation.indexCount = indexCount;
+	allocation.indexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	return allocation;
+}
+
+void GeometryArena::Free(GeometryAllocation& allocation)
+{
+	// Pages are gone after Shutdown, meshes destroyed later have nothing to return
+	if (!allocation.IsValid() || allocation.page >= pages.size())
+	{
+		allocation = GeometryAllocation();
+		return;
+	}
+
+	Page& page = pages[allocation.page];
+	page.vertices.Free(allocation.vertexOffset, allocation.vertexCount);
+	page.indices.Free(allocation.indexOffset, allocation.indexWords);
+	page.allocationCount--;
+
+	allocation = GeometryAllocation();
+}
+
+void GeometryArena::Shutdown()
+{
+	for (Page& page : pages)
+	{
+		glDeleteVertexArrays(1, &page.vao);
+		GLStateCache::GetInstance().OnVertexArrayDeleted(page.vao);
+		glDeleteBuffers(1, &page.vbo);
+		glDeleteBuffers(1, &page.ebo);
+	}
+	pages.clear();
+	indices32.clear();
+	indices16.clear();
+}
+
+void GeometryArena::Draw(const GeometryAllocation& allocation)
+{
+	if (!allocation.IsValid())
+	{
+		return;
+	}
+
+	BindPage(pages[allocation.page]);
+	const void* indexStart = reinterpret_cast<const void*>(static_cast<uintptr_t>(allocation.indexOffset) * sizeof(GLuint));
+#ifdef GEOMETRY_ARENA_REBASE_INDICES
+	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(allocation.indexCount), allocation.indexType, indexStart);
+#else
+	glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(allocation.indexCount), allocation.indexType, indexStart, static_cast<GLint>(allocation.vertexOffset));
+#endif
+	RENDER_STATS_ADD(drawCalls, 1);
+	RENDER_STATS_ADD(triangles, allocation.indexCount / 3);
+}
+
+void GeometryArena::DrawInstanced(const GeometryAllocation& allocation, VBO& instanceBuffer, size_t byteOffset, GLsizei instanceCount, GLuint matrixLocation)
+{
+	if (!allocation.IsValid())
+	{
+		return;
+	}
+
+	BindPage(pages[allocation.page]);
+
+	// GL 3.3 / ES 3.0 have no base instance, so the matrix attributes are re-pointed at this run's slice
+	instanceBuffer.Bind();
+	for (GLuint column = 0; column < 4; column++)
+	{
+		GLuint location = matrixLocation + column;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(byteOffset + column * sizeof(glm::vec4)));
+		glVertexAttribDivisor(location, 1);
+	}
+	instanceBuffer.Unbind();
+
+	const void* indexStart = reinterpret_cast<const void*>(static_cast<uintptr_t>(allocation.indexOffset) * sizeof(GLuint));
+#ifdef GEOMETRY_ARENA_REBASE_INDICES
+	glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(allocation.indexCount), allocation.indexType, indexStart, instanceCount);
+#else
+	glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(allocation.indexCount), allocation.indexType, indexStart, instanceCount, static_cast<GLint>(allocation.vertexOffset));
+#endif
+	RENDER_STATS_ADD(drawCalls, 1);
+	RENDER_STATS_ADD(instancedDrawCalls, 1);
+	RENDER_STATS_ADD(triangles, static_cast<uint64_t>(allocation.indexCount / 3) * instanceCount);
+}
+
+GeometryArena::Stats GeometryArena::GetStats() const
+{
+	Stats stats;
+	for (const Page& page : pages)
+	{
+		stats.pageCount++;
+		stats.allocationCount += page.allocationCount;
+		stats.reservedBytes += static_cast<size_t>(page.vertices.GetCapacity()) * sizeof(PackedVertex) + static_cast<size_t>(page.indices.GetCapacity()) * sizeof(GLuint);
+		stats.usedBytes += static_cast<size_t>(page.vertices.GetUsed()) * sizeof(PackedVertex) + static_cast<size_t>(page.indices.GetUsed()) * sizeof(GLuint);
+	}
+	return stats;
+}
+
+uint32_t GeometryArena::CreatePage(uint32_t vertexCapacity, uint32_t indexWordCapacity)
+{
+	Page page;
+	page.vertices = RangeAllocator(vertexCapacity);
+	page.indices = RangeAllocator(indexWordCapacity);
+
+	glGenVertexArrays(1, &page.vao);
+	glGenBuffers(1, &page.vbo);
+	glGenBuffers(1, &page.ebo);
+
+	GLStateCache::GetInstance().BindVertexArray(page.vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexCapacity) * sizeof(PackedVertex), nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexWordCapacity) * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+	// Position, unorm16 within the mesh bounds
+	glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+	glEnableVertexAttribArray(0);
+	// Normal, snorm16 octahedral
+	glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+	glEnableVertexAttribArray(1);
+	// Texture, half float
+	glVertexAttribPointer(3, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texUV));
+	glEnableVertexAttribArray(3);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	pages.push_back(std::move(page));
+	std::cout << "[GeometryArena] Created page " << pages.size() - 1 << " (" << vertexCapacity << " vertices, " << indexWordCapacity * 2 << " 16-bit indices)" << std::endl;
+	return static_cast<uint32_t>(pages.size() - 1);
+}
+
+void GeometryArena::BindPage(const Page& page)
+{
+	GLStateCache::GetInstance().BindVertexArray(page.vao);
+}
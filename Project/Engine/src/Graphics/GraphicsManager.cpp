@@ -1,5 +1,15 @@
 #include "pch.h"
 #include "Graphics/GraphicsManager.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/RenderStats.hpp"
+#include "Graphics/UniformBuffers.hpp"
+#include "Graphics/ClusteredLighting.hpp"
+#include "Threading/JobSystem.hpp"
+#include "Graphics/GeometryArena.hpp"
+#include "Graphics/RenderThread.hpp"
+#include "Graphics/SpatialIndexSystem.hpp"
+#include "Graphics/StaticBatcher.hpp"
+#include "Graphics/Model/ModelSystem.hpp"
 #include "WindowManager.hpp"
 
 GraphicsManager& GraphicsManager::GetInstance()
@@ -16,29 +26,121 @@ bool GraphicsManager::Initialize(int window_width, int window_height)
 void GraphicsManager::Shutdown()
 {
 	renderQueue.clear();
+	staticMeshQueue.clear();
+	textQueue.clear();
+	directFrame.Reset();
+	recordingFrame = nullptr;
+	currentWorld.reset();
+	worldPool.clear();
+	UniformBuffers::GetInstance().Shutdown();
+	ClusteredLighting::GetInstance().Shutdown();
+	GeometryArena::GetInstance().Shutdown();
+	textBatcher.Shutdown();
 	currentCamera = nullptr;
 	std::cout << "[GraphicsManager] Shutdown" << std::endl;
 }
 
+void GraphicsManager::NewFrame()
+{
+	frameNumber++;
+}
+
+RenderWorld* GraphicsManager::BeginWorldExtraction()
+{
+	if (currentWorld && worldFrameNumber == frameNumber)
+	{
+		return nullptr;
+	}
+
+	// Only the pool still holding a world means no frame in flight draws from it
+	currentWorld.reset();
+	for (const auto& world : worldPool)
+	{
+		if (world.use_count() == 1)
+		{
+			currentWorld = world;
+			break;
+		}
+	}
+	if (!currentWorld)
+	{
+		currentWorld = worldPool.emplace_back(std::make_shared<RenderWorld>());
+	}
+
+	currentWorld->Clear();
+	worldFrameNumber = frameNumber;
+	return currentWorld.get();
+}
+
 void GraphicsManager::BeginFrame()
 {
 	renderQueue.clear();
+	staticMeshQueue.clear();
+	textQueue.clear();
+	frameViewDirty = true;
+
+	// With the render thread running, the frame is recorded into a ring slot and drawn later.
+	// Otherwise it is drawn as soon as it's recorded
+	deferredFrame = RenderThread::GetInstance().IsRunning();
+	if (deferredFrame)
+	{
+		recordingFrame = &RenderThread::GetInstance().AcquireFrame();
+	}
+	else
+	{
+		directFrame.Reset();
+		recordingFrame = &directFrame;
+	}
 }
 
 void GraphicsManager::EndFrame()
 {
-
+	if (deferredFrame && recordingFrame)
+	{
+		RenderThread::GetInstance().PublishFrame();
+	}
+	recordingFrame = nullptr;
+	deferredFrame = false;
 }
 
 void GraphicsManager::Clear(float r, float g, float b, float a)
 {
+	if (deferredFrame && recordingFrame)
+	{
+		recordingFrame->clear = true;
+		recordingFrame->clearColor = glm::vec4(r, g, b, a);
+		return;
+	}
+
 	glClearColor(r, g, b, a);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
+void GraphicsManager::SubmitRenderCommand(std::function<void()> command)
+{
+	if (deferredFrame && recordingFrame)
+	{
+		recordingFrame->commands.push_back(std::move(command));
+		return;
+	}
+	command();
+}
+
 void GraphicsManager::SetCamera(Camera* camera)
 {
 	currentCamera = camera;
+	frameViewDirty = true;
+}
+
+const FrameView& GraphicsManager::GetFrameView()
+{
+	if (frameViewDirty && currentCamera)
+	{
+		// Use the viewport dimensions so the aspect matches the target being rendered to
+		frameView = FrameView::Build(*currentCamera, WindowManager::GetViewportWidth(), WindowManager::GetViewportHeight(), nearPlane, farPlane);
+		frameViewDirty = false;
+	}
+	return frameView;
 }
 
 void GraphicsManager::Submit(std::unique_ptr<IRenderComponent> renderItem)
@@ -49,17 +151,34 @@ void GraphicsManager::Submit(std::unique_ptr<IRenderComponent> renderItem)
 	}
 }
 
-void GraphicsManager::SubmitModel(std::shared_ptr<Model> model, std::shared_ptr<Shader> shader, const Matrix4x4& transform)
+void GraphicsManager::SubmitModel(std::shared_ptr<Model> model, std::shared_ptr<Shader> shader, const Matrix4x4& transform, uint32_t lodLevel)
 {
 	if (model && shader) 
 	{
 		glm::mat4 glmTransform = ConvertMatrix4x4ToGLM(transform);
 		auto renderItem = std::make_unique<ModelRenderComponent>(model, shader);
 		renderItem->transform = glmTransform;
+		renderItem->lodLevel = lodLevel;
 		Submit(std::move(renderItem));
 	}
 }
 
+void GraphicsManager::SubmitStaticMesh(Mesh* mesh, Shader* shader, int renderOrder)
+{
+	if (mesh && shader)
+	{
+		staticMeshQueue.push_back(StaticMeshDraw{ mesh, shader, renderOrder });
+	}
+}
+
+void GraphicsManager::SubmitText(const TextRenderComponent& textItem)
+{
+	if (textItem.isVisible)
+	{
+		textQueue.push_back(&textItem);
+	}
+}
+
 void GraphicsManager::Render()
 {
 	if (!currentCamera) 
@@ -68,251 +187,672 @@ void GraphicsManager::Render()
 		return;
 	}
 
-	// Sort render queue by render order (lower numbers render first)
-	std::sort(renderQueue.begin(), renderQueue.end(),
-		[](const std::unique_ptr<IRenderComponent>& a, const std::unique_ptr<IRenderComponent>& b) {
-			return a->renderOrder < b->renderOrder;
-		});
-
-	// Render all items in the queue
-	for (const auto& renderItem : renderQueue) 
+	if (!recordingFrame)
 	{
-		// Cast to ModelRenderItem since that's what we have for now
-		// Later you can add a switch statement for different types
-		const ModelRenderComponent* modelItem = dynamic_cast<const ModelRenderComponent*>(renderItem.get());
-		const TextRenderComponent* textItem = dynamic_cast<const TextRenderComponent*>(renderItem.get());
+		directFrame.Reset();
+		recordingFrame = &directFrame;
+	}
+	RenderFrame& frame = *recordingFrame;
+	const FrameView& view = GetFrameView();
 
-		if (modelItem) 
+	// A world left over from an earlier frame is stale
+	const RenderWorld* world = currentWorld && worldFrameNumber == frameNumber ? currentWorld.get() : nullptr;
+	if (world)
+	{
+		if (world->staticBatcher)
 		{
-			RenderModel(*modelItem);
+			world->staticBatcher->Submit(*this, view.frustum);
 		}
-		else if (textItem) 
+		for (const TextRenderComponent* textItem : world->texts)
 		{
-			RenderText(*textItem);
+			SubmitText(*textItem);
 		}
+		frame.world = currentWorld;
+	}
+
+	// Text submitted by reference lives in components the next update can change, so a frame
+	// drawn later gets its own copies. Layouts are then rebuilt by the render thread each frame
+	if (deferredFrame)
+	{
+		for (const TextRenderComponent*& textItem : textQueue)
+		{
+			auto textCopy = std::make_unique<TextRenderComponent>(*textItem);
+			textItem = textCopy.get();
+			frame.ownedItems.push_back(std::move(textCopy));
+		}
+	}
+
+	BuildDrawPackets(view, frame.drawQueue, world);
+	frame.drawQueue.Sort();
+	frame.visibleObjects = static_cast<uint32_t>(visibleCount);
+	frame.culledObjects = static_cast<uint32_t>(culledCount);
+	frame.view = view;
+	frame.hasView = true;
+	LightManager::getInstance().captureLights(frame.lights);
+
+	// Packets point into the submitted items, the frame keeps them alive until it's drawn
+	for (auto& renderItem : renderQueue)
+	{
+		frame.ownedItems.push_back(std::move(renderItem));
+	}
+	renderQueue.clear();
+
+	if (!deferredFrame)
+	{
+		ExecuteFrame(frame);
 	}
 }
 
-void GraphicsManager::RenderModel(const ModelRenderComponent& item)
+void GraphicsManager::ExecuteFrame(RenderFrame& frame)
 {
-	if (!item.isVisible || !item.model || !item.shader) 
+	// The editor UI renders between views, so anything shadowed from the last view is stale
+	GLStateCache::GetInstance().Invalidate();
+
+	// Glyph pages drawn from by earlier views can be recycled again
+	GlyphAtlas::AdvanceFrame();
+
+	if (frame.clear)
 	{
-		return;
+		glClearColor(frame.clearColor.r, frame.clearColor.g, frame.clearColor.b, frame.clearColor.a);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
-	// Activate the shader
-	item.shader->Activate();
+	if (frame.hasView)
+	{
+		RENDER_STATS_ADD(visibleObjects, frame.visibleObjects);
+		RENDER_STATS_ADD(culledObjects, frame.culledObjects);
+		UpdateFrameUniforms(frame.view, frame.lights);
+		ExecuteDrawPackets(frame.drawQueue, frame.view);
+	}
 
-	// Set up all matrices and uniforms
-	SetupMatrices(*item.shader, item.transform);
+	for (const auto& command : frame.commands)
+	{
+		command();
+	}
+}
 
-	// Apply lighting
-	ApplyLighting(*item.shader);
+void GraphicsManager::BuildLayerOrders(const RenderWorld* world)
+{
+	// Map renderOrder values onto dense layer indices so they fit in the sort key
+	layerOrders.clear();
+	if (world)
+	{
+		// Most instances share a few orders, runs are skipped so the sort stays small
+		for (const RenderWorld::ModelInstance& instance : world->models)
+		{
+			if (layerOrders.empty() || layerOrders.back() != instance.renderOrder)
+			{
+				layerOrders.push_back(instance.renderOrder);
+			}
+		}
+	}
+	for (const auto& renderItem : renderQueue)
+	{
+		layerOrders.push_back(renderItem->renderOrder);
+	}
+	for (const StaticMeshDraw& staticDraw : staticMeshQueue)
+	{
+		layerOrders.push_back(staticDraw.renderOrder);
+	}
+	for (const TextRenderComponent* textItem : textQueue)
+	{
+		layerOrders.push_back(textItem->renderOrder);
+	}
+	std::sort(layerOrders.begin(), layerOrders.end());
+	layerOrders.erase(std::unique(layerOrders.begin(), layerOrders.end()), layerOrders.end());
+}
 
-	// Draw the model
-	item.model->Draw(*item.shader, *currentCamera);
+uint32_t GraphicsManager::GetLayer(int renderOrder) const
+{
+	return static_cast<uint32_t>(std::lower_bound(layerOrders.begin(), layerOrders.end(), renderOrder) - layerOrders.begin());
 }
 
-void GraphicsManager::ApplyLighting(Shader& shader)
+void GraphicsManager::BuildDrawPackets(const FrameView& view, RenderQueue& drawQueue, const RenderWorld* world)
 {
-	// Moved directly from your ModelSystem::applyLighting method
-	LightManager& lightManager = LightManager::getInstance();
+	BuildLayerOrders(world);
+
+	// The spatial index rejects most of the world for this view hierarchically, the jobs below
+	// then test the bounds of what's left
+	worldCandidates.clear();
+	if (world && world->spatialIndex)
+	{
+		worldQueryResults.clear();
+		world->spatialIndex->QueryFrustum(view.frustum, worldQueryResults);
+		for (Entity entity : worldQueryResults)
+		{
+			// The spatial index also holds entities without a model
+			if (entity < world->instanceOf.size() && world->instanceOf[entity] != RenderWorld::NO_INSTANCE)
+			{
+				worldCandidates.push_back(world->instanceOf[entity]);
+			}
+		}
+	}
+	else if (world)
+	{
+		for (uint32_t i = 0; i < world->models.size(); i++)
+		{
+			worldCandidates.push_back(i);
+		}
+	}
 
-	// Apply directional light
-	const auto& dirLight = lightManager.getDirectionalLight();
-	shader.setVec3("dirLight.direction", dirLight.direction);
-	shader.setVec3("dirLight.ambient", dirLight.ambient);
-	shader.setVec3("dirLight.diffuse", dirLight.diffuse);
-	shader.setVec3("dirLight.specular", dirLight.specular);
+	// Culling and packet building only read the world and the submitted items, so ranges of both
+	// are extracted in parallel, each into its own slice. The GL context is never touched here
+	const uint32_t worldCount = static_cast<uint32_t>(worldCandidates.size());
+	const uint32_t worldRangeCount = JobSystem::GetRangeCount(worldCount, EXTRACT_RANGE_SIZE);
+	const uint32_t itemCount = static_cast<uint32_t>(renderQueue.size());
+	const uint32_t rangeCount = worldRangeCount + JobSystem::GetRangeCount(itemCount, EXTRACT_RANGE_SIZE);
+	if (extractSlices.size() < rangeCount + 1)
+	{
+		extractSlices.resize(rangeCount + 1);
+	}
 
-	// Apply point lights
-	const auto& pointLights = lightManager.getPointLights();
-	for (size_t i = 0; i < pointLights.size() && i < 4; i++) 
+	// Each job only touches the levels of its own entities
+	uint8_t* lodLevels = worldCount > 0 ? GetViewLODLevels() : nullptr;
+	JobSystem::GetInstance().ParallelFor(worldCount, EXTRACT_RANGE_SIZE, [this, world, &view, lodLevels](uint32_t begin, uint32_t end, uint32_t rangeIndex)
+	{
+		ExtractWorldRange(begin, end, extractSlices[rangeIndex], *world, view, lodLevels);
+	});
+	JobSystem::GetInstance().ParallelFor(itemCount, EXTRACT_RANGE_SIZE, [this, &view, worldRangeCount](uint32_t begin, uint32_t end, uint32_t rangeIndex)
 	{
-		std::string base = "pointLights[" + std::to_string(i) + "]";
-		shader.setVec3(base + ".position", pointLights[i].position);
-		shader.setVec3(base + ".ambient", pointLights[i].ambient);
-		shader.setVec3(base + ".diffuse", pointLights[i].diffuse);
-		shader.setVec3(base + ".specular", pointLights[i].specular);
-		shader.setFloat(base + ".constant", pointLights[i].constant);
-		shader.setFloat(base + ".linear", pointLights[i].linear);
-		shader.setFloat(base + ".quadratic", pointLights[i].quadratic);
+		ExtractRange(begin, end, extractSlices[worldRangeCount + rangeIndex], view);
+	});
+
+	// Text submitted by reference and static batches are few, they fill the last slice here
+	ExtractSlice& tailSlice = extractSlices[rangeCount];
+	tailSlice.packets.clear();
+	tailSlice.culledCount = world ? world->models.size() - worldCount : 0;
+	tailSlice.visibleCount = 0;
+
+	// Text submitted by reference lives in its component, so it isn't copied every frame
+	for (const TextRenderComponent* textItem : textQueue)
+	{
+		AddTextPacket(*textItem, GetLayer(textItem->renderOrder), view, tailSlice.packets);
 	}
 
-	// Apply spotlight
-	if (lightManager.isSpotLightEnabled() && currentCamera) 
+	// Static batches were culled by their owner and are already in world space
+	for (const StaticMeshDraw& staticDraw : staticMeshQueue)
 	{
-		const auto& spotLight = lightManager.getSpotLight();
-		shader.setVec3("spotLight.position", currentCamera->Position);
-		shader.setVec3("spotLight.direction", currentCamera->Front);
-		shader.setVec3("spotLight.ambient", spotLight.ambient);
-		shader.setVec3("spotLight.diffuse", spotLight.diffuse);
-		shader.setVec3("spotLight.specular", spotLight.specular);
-		shader.setFloat("spotLight.constant", spotLight.constant);
-		shader.setFloat("spotLight.linear", spotLight.linear);
-		shader.setFloat("spotLight.quadratic", spotLight.quadratic);
-		shader.setFloat("spotLight.cutOff", spotLight.cutOff);
-		shader.setFloat("spotLight.outerCutOff", spotLight.outerCutOff);
+		Material* material = staticDraw.mesh->material.get();
+		float depth01 = glm::dot(staticDraw.mesh->localBounds.Center() - view.cameraPosition, view.cameraFront) / view.farPlane;
+
+		DrawPacket& packet = tailSlice.packets.emplace_back();
+		packet.mesh = staticDraw.mesh;
+		packet.material = material;
+		packet.shader = staticDraw.shader;
+		packet.transform = glm::mat4(1.0f);
+		packet.isTransparent = false;
+		packet.sortKey = RenderSortKey::MakeOpaque(GetLayer(staticDraw.renderOrder), staticDraw.shader->ID, material ? material->getSortId() : 0, staticDraw.mesh->GetSortId(), 0, depth01);
+	}
+
+	// Merge in range order, so packets keep submission order no matter which thread built them
+	drawQueue.Clear();
+	culledCount = 0;
+	visibleCount = 0;
+	for (uint32_t slice = 0; slice <= rangeCount; slice++)
+	{
+		drawQueue.Append(extractSlices[slice].packets);
+		culledCount += extractSlices[slice].culledCount;
+		visibleCount += extractSlices[slice].visibleCount;
 	}
 }
 
-void GraphicsManager::SetupMatrices(Shader& shader, const glm::mat4& modelMatrix)
+void GraphicsManager::ExtractRange(uint32_t begin, uint32_t end, ExtractSlice& slice, const FrameView& view)
 {
-	shader.setMat4("model", modelMatrix);
+	const Frustum& viewFrustum = view.frustum;
+
+	slice.packets.clear();
+	slice.cullItemIndices.clear();
+	slice.cullCenterX.clear();
+	slice.cullCenterY.clear();
+	slice.cullCenterZ.clear();
+	slice.cullRadius.clear();
+	slice.culledCount = 0;
+	slice.visibleCount = 0;
 
-	if (currentCamera) 
+	// Anything that isn't a model (text) has no bounds and is always kept
+	slice.itemVisible.assign(end - begin, 1);
+
+	for (uint32_t i = begin; i < end; i++)
 	{
-		glm::mat4 view = currentCamera->GetViewMatrix();
-		shader.setMat4("view", view);
+		const ModelRenderComponent* modelItem = dynamic_cast<const ModelRenderComponent*>(renderQueue[i].get());
+		if (!modelItem || !modelItem->model)
+		{
+			continue;
+		}
 
-		// Get window dimensions with safety checks
-		int windowWidth = WindowManager::GetWindowWidth();
-		int windowHeight = WindowManager::GetWindowHeight();
+		BoundingSphere worldSphere = modelItem->model->localSphere.Transformed(modelItem->transform);
+		slice.cullItemIndices.push_back(i);
+		slice.cullCenterX.push_back(worldSphere.center.x);
+		slice.cullCenterY.push_back(worldSphere.center.y);
+		slice.cullCenterZ.push_back(worldSphere.center.z);
+		slice.cullRadius.push_back(worldSphere.radius);
+	}
+
+	slice.cullResults.resize(slice.cullItemIndices.size());
+	viewFrustum.TestSpheres(slice.cullCenterX.data(), slice.cullCenterY.data(), slice.cullCenterZ.data(), slice.cullRadius.data(), slice.cullItemIndices.size(), slice.cullResults.data());
+
+	for (size_t i = 0; i < slice.cullItemIndices.size(); i++)
+	{
+		uint32_t itemIndex = slice.cullItemIndices[i];
+		bool visible = slice.cullResults[i] != 0;
+
+		// Spheres are loose, so survivors get the tighter box test
+		if (visible)
+		{
+			const ModelRenderComponent* modelItem = static_cast<const ModelRenderComponent*>(renderQueue[itemIndex].get());
+			visible = viewFrustum.IntersectsAABB(modelItem->model->localBounds.Transformed(modelItem->transform));
+		}
+
+		slice.itemVisible[itemIndex - begin] = visible ? 1 : 0;
+		if (visible)
+		{
+			slice.visibleCount++;
+		}
+		else
+		{
+			slice.culledCount++;
+		}
+	}
 
-		// Prevent division by zero and ensure minimum dimensions
-		if (windowWidth <= 0) windowWidth = 1;
-		if (windowHeight <= 0) windowHeight = 1;
+	for (uint32_t itemIndex = begin; itemIndex < end; itemIndex++)
+	{
+		if (!slice.itemVisible[itemIndex - begin])
+		{
+			continue;
+		}
 
-		float aspectRatio = (float)windowWidth / (float)windowHeight;
+		const auto& renderItem = renderQueue[itemIndex];
+		uint32_t layer = GetLayer(renderItem->renderOrder);
 
-		// Clamp aspect ratio to reasonable bounds to prevent assertion errors
-		if (aspectRatio < 0.001f) aspectRatio = 0.001f;
-		if (aspectRatio > 1000.0f) aspectRatio = 1000.0f;
+		const ModelRenderComponent* modelItem = dynamic_cast<const ModelRenderComponent*>(renderItem.get());
+		const TextRenderComponent* textItem = dynamic_cast<const TextRenderComponent*>(renderItem.get());
 
-		glm::mat4 projection = glm::perspective(
-			glm::radians(currentCamera->Zoom),
-			aspectRatio,
-			0.1f, 100.0f
-		);
-		shader.setMat4("projection", projection);
+		if (modelItem)
+		{
+			if (!modelItem->model || !modelItem->shader)
+			{
+				continue;
+			}
 
-		shader.setVec3("cameraPos", currentCamera->Position);
+			AddModelPackets(*modelItem->model, modelItem->shader.get(), modelItem->transform, modelItem->lodLevel, layer, view, slice.packets);
+		}
+		else if (textItem)
+		{
+			AddTextPacket(*textItem, layer, view, slice.packets);
+		}
 	}
 }
 
-void GraphicsManager::SubmitText(const std::string& text, std::shared_ptr<Font> font, std::shared_ptr<Shader> shader, const glm::vec3& position, const glm::vec3& color, float scale, bool is3D, const glm::mat4& transform)
+void GraphicsManager::ExtractWorldRange(uint32_t begin, uint32_t end, ExtractSlice& slice, const RenderWorld& world, const FrameView& view, uint8_t* lodLevels)
 {
-	if (font && shader && !text.empty()) 
+	const Frustum& viewFrustum = view.frustum;
+	const std::vector<RenderWorld::ModelInstance>& instances = world.models;
+
+	slice.packets.clear();
+	slice.cullCenterX.clear();
+	slice.cullCenterY.clear();
+	slice.cullCenterZ.clear();
+	slice.cullRadius.clear();
+	slice.culledCount = 0;
+	slice.visibleCount = 0;
+
+	// World bounds were computed once at extraction, views only test them
+	for (uint32_t i = begin; i < end; i++)
 	{
-		auto textItem = std::make_unique<TextRenderComponent>(text, font, shader);
-		textItem->position = position;
-		textItem->color = color;
-		textItem->scale = scale;
-		textItem->is3D = is3D;
-		textItem->transform = transform;
-		Submit(std::move(textItem));
+		const BoundingSphere& worldSphere = instances[worldCandidates[i]].worldSphere;
+		slice.cullCenterX.push_back(worldSphere.center.x);
+		slice.cullCenterY.push_back(worldSphere.center.y);
+		slice.cullCenterZ.push_back(worldSphere.center.z);
+		slice.cullRadius.push_back(worldSphere.radius);
+	}
+
+	slice.cullResults.resize(end - begin);
+	viewFrustum.TestSpheres(slice.cullCenterX.data(), slice.cullCenterY.data(), slice.cullCenterZ.data(), slice.cullRadius.data(), end - begin, slice.cullResults.data());
+
+	for (uint32_t i = begin; i < end; i++)
+	{
+		const RenderWorld::ModelInstance& instance = instances[worldCandidates[i]];
+
+		// Spheres are loose, so survivors get the tighter box test
+		if (!slice.cullResults[i - begin] || !viewFrustum.IntersectsAABB(instance.worldBounds))
+		{
+			slice.culledCount++;
+			continue;
+		}
+		slice.visibleCount++;
+
+		// projection[1][1] is cot(fov / 2), so radius * cot / distance is the fraction of the screen height covered
+		uint32_t lodLevel = 0;
+		uint32_t lodCount = instance.model->GetLODCount();
+		if (lodCount > 1)
+		{
+			float distance = glm::length(instance.worldSphere.center - view.cameraPosition);
+			float coverage = distance > instance.worldSphere.radius ? instance.worldSphere.radius * view.projection[1][1] / distance : 1.0f;
+			lodLevel = ModelSystem::SelectLOD(coverage, lodLevels[instance.entity], lodCount);
+		}
+		lodLevels[instance.entity] = static_cast<uint8_t>(lodLevel);
+
+		AddModelPackets(*instance.model, instance.shader.get(), instance.transform, lodLevel, GetLayer(instance.renderOrder), view, slice.packets);
 	}
 }
 
-void GraphicsManager::RenderText(const TextRenderComponent& item)
+uint8_t* GraphicsManager::GetViewLODLevels()
 {
-	if (!item.isVisible || !item.font || !item.shader || item.text.empty()) 
+	// The camera may be gone, its address could come back as a different one
+	viewLODStates.erase(std::remove_if(viewLODStates.begin(), viewLODStates.end(), [this](const ViewLODState& state)
 	{
-		return;
+		return state.camera != currentCamera && frameNumber - state.lastUsedFrame > VIEW_LOD_EVICT_FRAMES;
+	}), viewLODStates.end());
+
+	ViewLODState* state = nullptr;
+	for (ViewLODState& candidate : viewLODStates)
+	{
+		if (candidate.camera == currentCamera)
+		{
+			state = &candidate;
+			break;
+		}
 	}
+	if (!state)
+	{
+		state = &viewLODStates.emplace_back();
+		state->camera = currentCamera;
+		state->levels.assign(MAX_ENTITIES, 0);
+	}
+	state->lastUsedFrame = frameNumber;
+	return state->levels.data();
+}
 
-	// Enable blending for text transparency
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+void GraphicsManager::AddModelPackets(Model& model, Shader* shader, const glm::mat4& transform, uint32_t lodLevel, uint32_t layer, const FrameView& view, std::vector<DrawPacket>& packets)
+{
+	glm::vec3 position = glm::vec3(transform[3]);
+	float depth01 = glm::dot(position - view.cameraPosition, view.cameraFront) / view.farPlane;
 
-	// Activate shader and set uniforms
-	item.shader->Activate();
-	item.shader->setVec3("textColor", item.color);
+	const bool testMeshes = model.meshes.size() > 1;
 
-	// Set up matrices based on whether it's 2D or 3D text
-	if (item.is3D) 
+	for (Mesh& mesh : model.meshes)
 	{
-		// 3D text rendering - use normal 3D matrices
-		SetupMatrices(*item.shader, item.transform);
+		// The model as a whole is visible, but individual parts can still be off screen
+		if (testMeshes && !view.frustum.IntersectsAABB(mesh.localBounds.Transformed(transform)))
+		{
+			continue;
+		}
+
+		Material* material = mesh.material.get();
+		bool isTransparent = material && material->getOpacity() < 1.0f;
+		uint32_t materialId = material ? material->getSortId() : 0;
+
+		// Meshes with fewer levels than the model use their coarsest one
+		static_assert(Mesh::MAX_LODS <= (1u << RenderSortKey::LOD_BITS), "Every LOD must fit the sort key");
+		uint32_t lod = std::min(lodLevel, mesh.GetLODCount() - 1);
+
+		DrawPacket& packet = packets.emplace_back();
+		packet.mesh = &mesh;
+		packet.material = material;
+		packet.shader = shader;
+		packet.transform = transform;
+		packet.lod = lod;
+		packet.isTransparent = isTransparent;
+		packet.sortKey = isTransparent
+			? RenderSortKey::MakeTransparent(layer, shader->ID, materialId, mesh.GetSortId(), lod, depth01)
+			: RenderSortKey::MakeOpaque(layer, shader->ID, materialId, mesh.GetSortId(), lod, depth01);
 	}
-	else 
+}
+
+void GraphicsManager::AddTextPacket(const TextRenderComponent& textItem, uint32_t layer, const FrameView& view, std::vector<DrawPacket>& packets)
+{
+	if (!textItem.shader)
 	{
-		// 2D screen space text rendering
-		Setup2DTextMatrices(*item.shader, item.position, item.scale);
+		return;
 	}
 
-	// Bind VAO and render each character
-	glActiveTexture(GL_TEXTURE0);
-	VAO* fontVAO = item.font->GetVAO();
-	VBO* fontVBO = item.font->GetVBO();
+	// Text blends, so it goes in the transparent range. 2D text keeps submission order
+	float depth01 = textItem.is3D ? glm::dot(glm::vec3(textItem.transform[3]) - view.cameraPosition, view.cameraFront) / view.farPlane : 0.0f;
+
+	DrawPacket& packet = packets.emplace_back();
+	packet.item = &textItem;
+	packet.shader = textItem.shader.get();
+	packet.isTransparent = true;
+	packet.sortKey = RenderSortKey::MakeTransparent(layer, textItem.shader->ID, 0, 0, 0, depth01);
+}
+
+void GraphicsManager::BuildDrawBatches(const RenderQueue& drawQueue)
+{
+	drawBatches.clear();
+	instanceTransforms.clear();
+	textBatcher.Clear();
 
-	if (!fontVAO || !fontVBO) 
+	const auto& entries = drawQueue.GetSortedEntries();
+	const uint32_t entryCount = static_cast<uint32_t>(entries.size());
+
+	uint32_t first = 0;
+	while (first < entryCount)
 	{
-		std::cerr << "[GraphicsManager] Font VAO/VBO not initialized!" << std::endl;
-		glDisable(GL_BLEND);
-		return;
-	}
+		const DrawPacket& head = drawQueue.GetPacket(entries[first].index);
 
-	fontVAO->Bind();
+		if (head.item)
+		{
+			// Adjacent text with the same font (so the same atlas) and shader is drawn from one range of the text buffer
+			const TextRenderComponent* headText = dynamic_cast<const TextRenderComponent*>(head.item);
+			DrawBatch batch{ first, 1, DrawBatch::NOT_INSTANCED, textBatcher.GetVertexCount(), 0 };
+			if (headText)
+			{
+				batch.vertexCount = textBatcher.Append(*headText);
+				while (first + batch.count < entryCount)
+				{
+					const DrawPacket& next = drawQueue.GetPacket(entries[first + batch.count].index);
+					const TextRenderComponent* nextText = next.item ? dynamic_cast<const TextRenderComponent*>(next.item) : nullptr;
+					if (!nextText || nextText->font != headText->font || next.shader != head.shader || nextText->is3D != headText->is3D)
+					{
+						break;
+					}
+					batch.vertexCount += textBatcher.Append(*nextText);
+					batch.count++;
+				}
+			}
+
+			drawBatches.push_back(batch);
+			first += batch.count;
+			continue;
+		}
 
-	float x = 0.0f;
-	float y = 0.0f;
+		// Opaque packets sort by program, material and mesh before depth, so identical draws are adjacent
+		uint32_t count = 1;
+		if (!head.isTransparent)
+		{
+			while (first + count < entryCount)
+			{
+				const DrawPacket& next = drawQueue.GetPacket(entries[first + count].index);
+				if (next.item || next.isTransparent || next.mesh != head.mesh || next.lod != head.lod || next.material != head.material || next.shader != head.shader)
+				{
+					break;
+				}
+				count++;
+			}
+		}
+
+		DrawBatch batch{ first, count, DrawBatch::NOT_INSTANCED };
+		if (count >= MIN_INSTANCE_COUNT && head.shader->GetInstancedVariant())
+		{
+			batch.instanceOffset = static_cast<uint32_t>(instanceTransforms.size());
+			for (uint32_t i = 0; i < count; i++)
+			{
+				instanceTransforms.push_back(drawQueue.GetPacket(entries[first + i].index).transform);
+			}
+		}
+		else
+		{
+			// Not worth instancing, draw each packet on its own
+			batch.count = 1;
+			count = 1;
+		}
 
-	// Calculate starting position based on alignment
-	if (item.alignment == TextRenderComponent::Alignment::CENTER) 
+		drawBatches.push_back(batch);
+		first += count;
+	}
+}
+
+void GraphicsManager::UploadInstanceTransforms()
+{
+	if (instanceTransforms.empty())
 	{
-		x = -item.font->GetTextWidth(item.text, item.scale) / 2.0f;
+		return;
 	}
 
-	else if (item.alignment == TextRenderComponent::Alignment::RIGHT) 
+	size_t requiredSize = instanceTransforms.size() * sizeof(glm::mat4);
+	if (!instanceVBO)
+	{
+		instanceVBO = std::make_unique<VBO>(requiredSize, GL_STREAM_DRAW);
+		instanceCapacity = requiredSize;
+	}
+	else if (requiredSize > instanceCapacity)
+	{
+		// Grow geometrically so the buffer settles after a few frames
+		instanceCapacity = std::max(requiredSize, instanceCapacity * 2);
+		instanceVBO->InitializeBuffer(instanceCapacity, GL_STREAM_DRAW);
+	}
+	else
 	{
-		x = -item.font->GetTextWidth(item.text, item.scale);
+		// Orphan the old storage so we don't wait on draws from the previous view
+		instanceVBO->InitializeBuffer(instanceCapacity, GL_STREAM_DRAW);
 	}
 
-	// Iterate through all characters
-	for (char c : item.text) 
+	instanceVBO->UpdateData(instanceTransforms.data(), requiredSize);
+	instanceVBO->Unbind();
+}
+
+void GraphicsManager::ExecuteDrawPackets(const RenderQueue& drawQueue, const FrameView& frameView)
+{
+	BuildDrawBatches(drawQueue);
+	UploadInstanceTransforms();
+	textBatcher.Upload();
+
+	GLStateCache& stateCache = GLStateCache::GetInstance();
+	const auto& entries = drawQueue.GetSortedEntries();
+	Shader* boundShader = nullptr;
+	Material* boundMaterial = nullptr;
+	Mesh* boundGeometry = nullptr;
+
+	for (const DrawBatch& batch : drawBatches)
 	{
-		const Character& ch = item.font->GetCharacter(c);
-		if (ch.textureID == 0) {
-			std::cerr << "Character '" << c << "' has no texture!" << std::endl;
+		const DrawPacket& packet = drawQueue.GetPacket(entries[batch.first].index);
+
+		if (packet.item)
+		{
+			const TextRenderComponent* textItem = dynamic_cast<const TextRenderComponent*>(packet.item);
+			if (textItem)
+			{
+				RenderTextBatch(*textItem, batch, frameView);
+			}
+
+			// Text rendering changes program and textures behind our back
+			boundShader = nullptr;
+			boundMaterial = nullptr;
+			boundGeometry = nullptr;
 			continue;
 		}
 
-		float xpos = x + ch.bearing.x * item.scale;
-		float ypos = y - (ch.size.y - ch.bearing.y) * item.scale;
+		stateCache.SetBlend(packet.isTransparent);
+		if (packet.isTransparent)
+		{
+			stateCache.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
 
-		float w = ch.size.x * item.scale;
-		float h = ch.size.y * item.scale;
+		bool isInstanced = batch.instanceOffset != DrawBatch::NOT_INSTANCED;
+		Shader* shader = isInstanced ? packet.shader->GetInstancedVariant() : packet.shader;
 
-		// Update VBO for each character
-		float vertices[6][4] = {
-			{ xpos,     ypos + h,   0.0f, 0.0f },
-			{ xpos,     ypos,       0.0f, 1.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
+		if (shader != boundShader)
+		{
+			shader->Activate();
+			boundShader = shader;
+			boundMaterial = nullptr;
+			boundGeometry = nullptr;
+		}
 
-			{ xpos,     ypos + h,   0.0f, 0.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
-			{ xpos + w, ypos + h,   1.0f, 0.0f }
-		};
+		// Meshes without a material use their own texture list, which can't be shared
+		if (!packet.material || packet.material != boundMaterial)
+		{
+			packet.mesh->ApplyMaterial(*shader);
+			boundMaterial = packet.material;
+		}
+
+		// Position decode uniforms only change with the mesh
+		if (packet.mesh != boundGeometry)
+		{
+			packet.mesh->ApplyGeometry(*shader);
+			boundGeometry = packet.mesh;
+		}
 
-		// Render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.textureID);
+		if (isInstanced)
+		{
+			packet.mesh->DrawGeometryInstanced(*instanceVBO, batch.instanceOffset * sizeof(glm::mat4), static_cast<GLsizei>(batch.count), packet.lod);
+		}
+		else
+		{
+			shader->setMat4(Uniforms::Model, packet.transform);
+			packet.mesh->DrawGeometry(packet.lod);
+		}
+	}
 
-		// Update content of VBO memory using your extended VBO class
-		fontVBO->UpdateData(vertices, sizeof(vertices));
+	stateCache.SetBlend(false);
+}
 
-		// Render quad
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+void GraphicsManager::UpdateFrameUniforms(const FrameView& view, const LightSet& lights)
+{
+	// Camera and lights are shared by every draw in this view, so they are uploaded once
+	// into the uniform buffers instead of per program or per draw. Point and spot lights are
+	// binned into the view's clusters first, the light block then describes the cluster grid
+	ClusteredLighting::GetInstance().Update(lights, view);
+
+	UniformBuffers& uniformBuffers = UniformBuffers::GetInstance();
+	uniformBuffers.UpdateCamera(view);
+	uniformBuffers.UpdateLights(lights, view);
+}
 
-		// Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-		x += (ch.advance >> 6) * item.scale; // Bitshift by 6 to get value in pixels (2^6 = 64)
+void GraphicsManager::SubmitText(const std::string& text, std::shared_ptr<Font> font, std::shared_ptr<Shader> shader, const glm::vec3& position, const glm::vec3& color, float scale, bool is3D, const glm::mat4& transform)
+{
+	if (font && shader && !text.empty()) 
+	{
+		auto textItem = std::make_unique<TextRenderComponent>(text, font, shader);
+		textItem->position = position;
+		textItem->color = color;
+		textItem->scale = scale;
+		textItem->is3D = is3D;
+		textItem->transform = transform;
+		Submit(std::move(textItem));
 	}
-
-	fontVAO->Unbind();
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glDisable(GL_BLEND);
 }
 
-void GraphicsManager::Setup2DTextMatrices(Shader& shader, const glm::vec3& position, float scale)
+void GraphicsManager::RenderTextBatch(const TextRenderComponent& head, const DrawBatch& batch, const FrameView& frameView)
 {
-	glm::mat4 projection = glm::ortho(0.0f, (float)WindowManager::GetWindowWidth(), 0.0f, (float)WindowManager::GetWindowHeight());
+	if (batch.vertexCount == 0 || !head.font || !head.shader)
+	{
+		return;
+	}
+
+	// Enable blending for text transparency, consecutive text batches keep it enabled
+	GLStateCache& stateCache = GLStateCache::GetInstance();
+	stateCache.SetBlend(true);
+	stateCache.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	glm::mat4 model = glm::mat4(1.0f);
-	model = glm::translate(model, position);  // Use position as-is
-	model = glm::scale(model, glm::vec3(scale, scale, 1.0f));
+	head.shader->Activate();
+
+	// Quads are already in world space (3D) or viewport pixels (2D), only the projection is left.
+	// Both come from the recorded view, the live camera and window may already be on the next frame
+	if (head.is3D)
+	{
+		head.shader->setMat4(Uniforms::Projection, frameView.viewProjection);
+	}
+	else
+	{
+		glm::mat4 projection = glm::ortho(0.0f, (float)frameView.viewportWidth, 0.0f, (float)frameView.viewportHeight);
+		head.shader->setMat4(Uniforms::Projection, projection);
+	}
 
-	shader.setMat4("projection", projection);
-	shader.setMat4("model", model);
+	// Batches never mix atlases, so the glyph mode is the same for the whole draw
+	head.shader->setBool(Uniforms::TextDistanceField, head.font->GetGlyphMode() == Font::GlyphMode::SDF);
+	stateCache.BindTexture(0, head.font->GetAtlasTexture(), GL_TEXTURE_2D_ARRAY);
+	textBatcher.Draw(batch.firstVertex, batch.vertexCount);
 }
 
 glm::mat4 GraphicsManager::ConvertMatrix4x4ToGLM(const Matrix4x4& m)
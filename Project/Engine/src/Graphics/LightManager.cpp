@@ -8,6 +8,14 @@ LightManager& LightManager::getInstance()
     return instance;
 }
 
+void LightManager::captureLights(LightSet& lights) const
+{
+    lights.directionalLight = directionalLight;
+    lights.pointLights.assign(pointLights.begin(), pointLights.end());
+    lights.spotLight = spotLight;
+    lights.spotLightEnabled = spotLightEnabled;
+}
+
 void LightManager::setDirectionalLight(const glm::vec3& direction, const glm::vec3& ambient, const glm::vec3 diffuse, const glm::vec3& specular)
 {
     directionalLight.direction = direction;
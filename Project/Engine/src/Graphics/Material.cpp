@@ -1,10 +1,13 @@
 #include "pch.h"
 #include "Graphics/Material.hpp"
+#include "Graphics/GLStateCache.hpp"
 
-Material::Material() : m_name("DefaultMaterial") {
+uint32_t Material::s_nextSortId = 0;
+
+Material::Material() : m_name("DefaultMaterial"), m_sortId(s_nextSortId++) {
 }
 
-Material::Material(const std::string& name) : m_name(name) {
+Material::Material(const std::string& name) : m_name(name), m_sortId(s_nextSortId++) {
 }
 
 void Material::SetAmbient(const glm::vec3 ambient)
@@ -90,12 +93,12 @@ const std::string& Material::getName() const
 void Material::applyToShader(Shader& shader) const
 {
 	// Apply basic material properties
-	shader.setVec3("material.ambient", m_ambient);
-	shader.setVec3("material.diffuse", m_diffuse);
-	shader.setVec3("material.specular", m_specular);
-	shader.setVec3("material.emissive", m_emissive);
-	shader.setFloat("material.shininess", m_shininess);
-	shader.setFloat("material.opacity", m_opacity);
+	shader.setVec3(Uniforms::MaterialAmbient, m_ambient);
+	shader.setVec3(Uniforms::MaterialDiffuse, m_diffuse);
+	shader.setVec3(Uniforms::MaterialSpecular, m_specular);
+	shader.setVec3(Uniforms::MaterialEmissive, m_emissive);
+	shader.setFloat(Uniforms::MaterialShininess, m_shininess);
+	shader.setFloat(Uniforms::MaterialOpacity, m_opacity);
 
 	// Apply PBR properties - For Future Use
 	//shader.setFloat("material.metallic", m_metallic);
@@ -108,33 +111,26 @@ void Material::applyToShader(Shader& shader) const
 
 void Material::bindTextures(Shader& shader) const
 {
-	// Reset texture units to be safe
-	glActiveTexture(GL_TEXTURE0);
-	unsigned int textureUnit = 0;
-
 	// Set texture availability flags
-	shader.setBool("material.hasDiffuseMap", hasTexture(TextureType::DIFFUSE));
-	shader.setBool("material.hasSpecularMap", hasTexture(TextureType::SPECULAR));
-	shader.setBool("material.hasNormalMap", hasTexture(TextureType::NORMAL));
-	shader.setBool("material.hasEmissiveMap", hasTexture(TextureType::EMISSIVE));
+	shader.setBool(Uniforms::MaterialHasDiffuseMap, hasTexture(TextureType::DIFFUSE));
+	shader.setBool(Uniforms::MaterialHasSpecularMap, hasTexture(TextureType::SPECULAR));
+	shader.setBool(Uniforms::MaterialHasNormalMap, hasTexture(TextureType::NORMAL));
+	shader.setBool(Uniforms::MaterialHasEmissiveMap, hasTexture(TextureType::EMISSIVE));
 	// For Future Use
 	/*shader.setBool("material.hasHeightMap", hasTexture(TextureType::HEIGHT));
 	shader.setBool("material.hasAOMap", hasTexture(TextureType::AMBIENT_OCCLUSION));
 	shader.setBool("material.hasMetallicMap", hasTexture(TextureType::METALLIC));
 	shader.setBool("material.hasRoughnessMap", hasTexture(TextureType::ROUGHNESS));*/
 
-	// Bind each texture type
+	// Bind each texture type. Every type has a fixed unit, so materials sharing a texture
+	// leave it bound and the state cache skips the rebind
 	for (const auto& [type, texture] : m_textures)
 	{
-		if (texture && textureUnit < 16) 
+		if (texture) 
 		{
-			glActiveTexture(GL_TEXTURE0 + textureUnit);
-			texture->Bind();
-
-			std::string uniformName = "material." + textureTypeToString(type);
-			shader.setInt(uniformName.c_str(), textureUnit);
-
-			textureUnit++;
+			GLuint textureUnit = textureTypeToUnit(type);
+			GLStateCache::GetInstance().BindTexture(textureUnit, texture->ID);
+			shader.setInt(textureTypeToUniform(type), static_cast<int>(textureUnit));
 		}
 	}
 }
@@ -202,6 +198,27 @@ std::string Material::textureTypeToString(TextureType type) const
 	}
 }
 
+UniformID Material::textureTypeToUniform(TextureType type)
+{
+	switch (type) 
+	{
+		case TextureType::DIFFUSE: return Uniforms::MaterialDiffuseMap;
+		case TextureType::SPECULAR: return Uniforms::MaterialSpecularMap;
+		case TextureType::NORMAL: return Uniforms::MaterialNormalMap;
+		case TextureType::HEIGHT: return Uniforms::MaterialHeightMap;
+		case TextureType::AMBIENT_OCCLUSION: return Uniforms::MaterialAOMap;
+		case TextureType::METALLIC: return Uniforms::MaterialMetallicMap;
+		case TextureType::ROUGHNESS: return Uniforms::MaterialRoughnessMap;
+		case TextureType::EMISSIVE: return Uniforms::MaterialEmissiveMap;
+		default: return Uniforms::MaterialDiffuseMap;
+	}
+}
+
+GLuint Material::textureTypeToUnit(TextureType type)
+{
+	return static_cast<GLuint>(type);
+}
+
 void Material::debugPrintProperties() const
 {
 	std::cout << "Material: " << m_name << std::endl;
@@ -1,61 +1,145 @@
 #include "pch.h"
 
 #include "Graphics/Mesh.h"
-#include "WindowManager.hpp"
+#include "Graphics/GLStateCache.hpp"
 
 
 Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::vector<std::shared_ptr<Texture>>& textures) : vertices(vertices), indices(indices), textures(textures)
 {
+	computeBounds();
 	setupMesh();
 }
 
 Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<GLuint>& indices, std::shared_ptr<Material> mat) : vertices(vertices), indices(indices), material(mat)
 {
+	computeBounds();
 	setupMesh();
 }
 
+void Mesh::computeBounds()
+{
+	localBounds = AABB();
+	for (const Vertex& vertex : vertices)
+	{
+		localBounds.Expand(vertex.position);
+	}
+
+	if (!localBounds.IsValid())
+	{
+		localSphere = BoundingSphere();
+		return;
+	}
+
+	// Center on the box, but take the radius from the actual vertices so it is tighter than the half diagonal
+	glm::vec3 center = localBounds.Center();
+	float maxDistanceSq = 0.0f;
+	for (const Vertex& vertex : vertices)
+	{
+		glm::vec3 offset = vertex.position - center;
+		maxDistanceSq = std::max(maxDistanceSq, glm::dot(offset, offset));
+	}
+	localSphere = BoundingSphere(center, std::sqrt(maxDistanceSq));
+}
+
 Mesh::~Mesh()
 {
-	vao.Delete();
+	GeometryArena::GetInstance().Free(geometry);
+	for (LOD& lod : lods)
+	{
+		GeometryArena::GetInstance().Free(lod.geometry);
+	}
 }
 
 void Mesh::setupMesh()
 {
-	// Generates Vertex Array Object and binds it
-	vao.Bind();
-
-	VBO vbo(vertices);
-	vbo.Bind();
-
-	EBO ebo(indices);
-
-	// Position
-	vao.LinkAttrib(vbo, 0, 3, GL_FLOAT, sizeof(Vertex), (void*)0); // Compiler knows the exact size of your Vertex struct (including any padding) no need 11 * sizeof(float)
-	// Normal
-	vao.LinkAttrib(vbo, 1, 3, GL_FLOAT, sizeof(Vertex), (void*)(3 * sizeof(float)));
-	// Color
-	vao.LinkAttrib(vbo, 2, 3, GL_FLOAT, sizeof(Vertex), (void*)(6 * sizeof(float)));
-	// Texture
-	vao.LinkAttrib(vbo, 3, 2, GL_FLOAT, sizeof(Vertex), (void*)(9 * sizeof(float)));
-
-	vao.Unbind();
-	vbo.Unbind();
-	ebo.Unbind();
+	// Geometry goes into the shared arena in the packed format, which owns the buffers and the vertex layout
+	positionDecode = PositionDecode::FromBounds(localBounds);
+
+	std::vector<PackedVertex> packedVertices;
+	packedVertices.reserve(vertices.size());
+	for (const Vertex& vertex : vertices)
+	{
+		packedVertices.push_back(VertexFormat::Pack(vertex, positionDecode));
+	}
+	geometry = GeometryArena::GetInstance().Allocate(packedVertices, indices);
+
+	setupTextureUniforms();
 }
 
-void Mesh::Draw(Shader& shader, const Camera& camera)
+void Mesh::setupTextureUniforms()
 {
-	shader.Activate();
-	vao.Bind();
+	textureUniformNames.clear();
+	textureUniforms.clear();
+
+	unsigned int numDiffuse = 0, numSpecular = 0;
+	for (const auto& texture : textures)
+	{
+		std::string num;
+		std::string type = texture ? texture->type : std::string();
+
+		if (type == "diffuse") {
+			num = std::to_string(numDiffuse++);
+		}
+		else if (type == "specular") {
+			num = std::to_string(numSpecular++);
+		}
+		textureUniformNames.push_back("material." + type + num);
+	}
 
-	// Set camera matrices
-	glm::mat4 view = camera.GetViewMatrix();
-	shader.setMat4("view", view);
+	// Only once all names are in place, so the ids don't point into strings that moved
+	for (const std::string& name : textureUniformNames)
+	{
+		textureUniforms.emplace_back(name.c_str());
+	}
+}
 
-	glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)WindowManager::GetViewportWidth() / (float)WindowManager::GetViewportHeight(), 0.1f, 100.0f);
-	shader.setMat4("projection", projection);
-	shader.setVec3("cameraPos", camera.Position);
+void Mesh::AddLOD(const std::vector<Vertex>& lodVertices, const std::vector<GLuint>& lodIndices, float error)
+{
+	if (lods.size() + 1 >= MAX_LODS)
+	{
+		return;
+	}
 
+	// Same decode as the base mesh, so switching levels never changes the uniforms
+	std::vector<PackedVertex> packedVertices;
+	packedVertices.reserve(lodVertices.size());
+	for (const Vertex& vertex : lodVertices)
+	{
+		packedVertices.push_back(VertexFormat::Pack(vertex, positionDecode));
+	}
+
+	LOD lod{ GeometryArena::GetInstance().Allocate(packedVertices, lodIndices), error };
+	if (lod.geometry.IsValid())
+	{
+		lods.push_back(lod);
+	}
+}
+
+uint32_t Mesh::GetTriangleCount(uint32_t lod) const
+{
+	return GetGeometry(lod).indexCount / 3;
+}
+
+const GeometryAllocation& Mesh::GetGeometry(uint32_t lod) const
+{
+	if (lod == 0 || lods.empty())
+	{
+		return geometry;
+	}
+	return lods[std::min<size_t>(lod, lods.size()) - 1].geometry;
+}
+
+void Mesh::Draw(Shader& shader)
+{
+	// Camera matrices come from the per-frame CameraData uniform block
+	shader.Activate();
+	ApplyMaterial(shader);
+	ApplyGeometry(shader);
+	DrawGeometry();
+}
+
+void Mesh::ApplyMaterial(Shader& shader)
+{
 	// Apply material if available
 	if (material)
 	{
@@ -65,30 +149,36 @@ void Mesh::Draw(Shader& shader, const Camera& camera)
 	else
 	{
 		// Fallback to old texture system for backward compatibility
-		unsigned int textureUnit = 0;
-		unsigned int numDiffuse = 0, numSpecular = 0;
+		if (textureUniforms.size() != textures.size())
+		{
+			// Textures were changed after setup
+			setupTextureUniforms();
+		}
 
+		unsigned int textureUnit = 0;
 		for (unsigned int i = 0; i < textures.size() && textureUnit < 16; i++)
 		{
 			if (!textures[i]) continue;
 
-			std::string num;
-			std::string type = textures[i]->type;
-
-			if (type == "diffuse") {
-				num = std::to_string(numDiffuse++);
-			}
-			else if (type == "specular") {
-				num = std::to_string(numSpecular++);
-			}
-
-			glActiveTexture(GL_TEXTURE0 + textureUnit);
-			textures[i]->Bind();
-			shader.setInt(("material." + type + num).c_str(), textureUnit);
+			GLStateCache::GetInstance().BindTexture(textureUnit, textures[i]->ID);
+			shader.setInt(textureUniforms[i], textureUnit);
 			textureUnit++;
 		}
 	}
+}
 
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+void Mesh::ApplyGeometry(Shader& shader)
+{
+	shader.setVec3(Uniforms::PositionOffset, positionDecode.offset);
+	shader.setVec3(Uniforms::PositionScale, positionDecode.scale);
 }
 
+void Mesh::DrawGeometry(uint32_t lod)
+{
+	GeometryArena::GetInstance().Draw(GetGeometry(lod));
+}
+
+void Mesh::DrawGeometryInstanced(VBO& instanceBuffer, size_t byteOffset, GLsizei instanceCount, uint32_t lod)
+{
+	GeometryArena::GetInstance().DrawInstanced(GetGeometry(lod), instanceBuffer, byteOffset, instanceCount, INSTANCE_MATRIX_LOCATION);
+}
@@ -0,0 +1,434 @@
+#include "pch.h"
+#include "Graphics/Model/MeshOptimizer.hpp"
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+	constexpr GLuint INVALID_INDEX = 0xFFFFFFFFu;
+
+	// FIFO cache simulation: a vertex is cached if it was pushed within the last cacheSize misses
+	class FifoCache {
+	public:
+		FifoCache(size_t vertexCount, size_t cacheSize) : pushedAt(vertexCount, 0), size(cacheSize) {}
+
+		// Returns true on a miss
+		bool Access(GLuint vertex)
+		{
+			if (pushedAt[vertex] != 0 && time - pushedAt[vertex] < size)
+			{
+				return false;
+			}
+			pushedAt[vertex] = ++time;
+			return true;
+		}
+
+	private:
+		std::vector<size_t> pushedAt; // 0 = never pushed
+		size_t time = 0;
+		size_t size;
+	};
+
+	// Key for welding, vertices are merged only when every component is bit-identical
+	struct VertexKey {
+		const Vertex* vertex;
+
+		bool operator==(const VertexKey& other) const
+		{
+			return std::memcmp(vertex, other.vertex, sizeof(Vertex)) == 0;
+		}
+	};
+
+	struct VertexKeyHash {
+		size_t operator()(const VertexKey& key) const
+		{
+			// FNV-1a over the raw vertex
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(key.vertex);
+			uint32_t hash = 2166136261u;
+			for (size_t i = 0; i < sizeof(Vertex); i++)
+			{
+				hash = (hash ^ bytes[i]) * 16777619u;
+			}
+			return hash;
+		}
+	};
+
+	// Forsyth's scoring. Recently used vertices score high (the last triangle's three slightly less,
+	// so strips don't run forever) and vertices with few triangles left are boosted so they get finished off
+	constexpr size_t FORSYTH_CACHE_SIZE = 32;
+	constexpr size_t FORSYTH_MAX_VALENCE = 32;
+
+	struct ForsythScores {
+		float cache[FORSYTH_CACHE_SIZE + 1]{};      // Index 0 = not in cache
+		float valence[FORSYTH_MAX_VALENCE + 1]{};
+
+		ForsythScores()
+		{
+			const float cacheDecayPower = 1.5f;
+			const float lastTriangleScore = 0.75f;
+			const float valenceBoostScale = 2.0f;
+			const float valenceBoostPower = 0.5f;
+
+			for (size_t position = 0; position < FORSYTH_CACHE_SIZE; position++)
+			{
+				float score = lastTriangleScore;
+				if (position >= 3)
+				{
+					float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+					score = std::pow(1.0f - (position - 3) * scaler, cacheDecayPower);
+				}
+				cache[position + 1] = score;
+			}
+
+			for (size_t remaining = 1; remaining <= FORSYTH_MAX_VALENCE; remaining++)
+			{
+				valence[remaining] = valenceBoostScale * std::pow(static_cast<float>(remaining), -valenceBoostPower);
+			}
+		}
+
+		float Score(int cachePosition, uint32_t remainingTriangles) const
+		{
+			if (remainingTriangles == 0)
+			{
+				return -1.0f;
+			}
+			return cache[cachePosition + 1] + valence[std::min<size_t>(remainingTriangles, FORSYTH_MAX_VALENCE)];
+		}
+	};
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(std::vector<Vertex>& vertices, std::vector<GLuint>& indices)
+{
+	Report report;
+	report.sourceVertices = vertices.size();
+	report.optimizedVertices = vertices.size();
+
+	// Lines and points left over after triangulation are passed through untouched
+	if (indices.empty() || indices.size() % 3 != 0)
+	{
+		return report;
+	}
+
+	report.before = AnalyzeVertexCache(indices, vertices.size());
+
+	WeldVertices(vertices, indices);
+	OptimizeVertexCache(indices, vertices.size());
+	OptimizeOverdraw(indices, vertices);
+	OptimizeVertexFetch(vertices, indices);
+
+	report.optimizedVertices = vertices.size();
+	report.after = AnalyzeVertexCache(indices, vertices.size());
+	return report;
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize)
+{
+	VertexCacheStats stats;
+	stats.triangles = indices.size() / 3;
+
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> referenced(vertexCount, false);
+	for (GLuint index : indices)
+	{
+		if (cache.Access(index))
+		{
+			stats.transformed++;
+		}
+		if (!referenced[index])
+		{
+			referenced[index] = true;
+			stats.vertices++;
+		}
+	}
+	return stats;
+}
+
+void MeshOptimizer::WeldVertices(std::vector<Vertex>& vertices, std::vector<GLuint>& indices)
+{
+	std::vector<GLuint> remap(vertices.size());
+	std::vector<Vertex> unique;
+	unique.reserve(vertices.size());
+
+	// Keys point into the source array, which stays untouched until the end
+	std::unordered_map<VertexKey, GLuint, VertexKeyHash> lookup;
+	lookup.reserve(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		auto [it, inserted] = lookup.emplace(VertexKey{ &vertices[i] }, static_cast<GLuint>(unique.size()));
+		if (inserted)
+		{
+			unique.push_back(vertices[i]);
+		}
+		remap[i] = it->second;
+	}
+
+	for (GLuint& index : indices)
+	{
+		index = remap[index];
+	}
+	vertices = std::move(unique);
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount)
+{
+	static const ForsythScores scores;
+
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// Triangles using each vertex, as ranges into one array. The first liveCount entries are still unemitted
+	std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+	for (GLuint index : indices)
+	{
+		adjacencyOffset[index + 1]++;
+	}
+	std::partial_sum(adjacencyOffset.begin(), adjacencyOffset.end(), adjacencyOffset.begin());
+
+	std::vector<uint32_t> liveCount(vertexCount, 0);
+	std::vector<uint32_t> adjacency(indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		GLuint vertex = indices[i];
+		adjacency[adjacencyOffset[vertex] + liveCount[vertex]++] = static_cast<uint32_t>(i / 3);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		vertexScore[v] = scores.Score(-1, liveCount[v]);
+	}
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	uint32_t best = 0;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		if (triangleScore[t] > triangleScore[best])
+		{
+			best = static_cast<uint32_t>(t);
+		}
+	}
+
+	std::vector<GLuint> output;
+	output.reserve(indices.size());
+	std::vector<GLuint> cache;
+	std::vector<GLuint> newCache;
+	cache.reserve(FORSYTH_CACHE_SIZE + 3);
+	newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+	size_t scanCursor = 0;
+
+	auto updateVertexScore = [&](GLuint vertex) {
+		float score = scores.Score(cachePosition[vertex], liveCount[vertex]);
+		float delta = score - vertexScore[vertex];
+		vertexScore[vertex] = score;
+		for (uint32_t i = 0; i < liveCount[vertex]; i++)
+		{
+			triangleScore[adjacency[adjacencyOffset[vertex] + i]] += delta;
+		}
+	};
+
+	while (output.size() < indices.size())
+	{
+		if (best == INVALID_INDEX)
+		{
+			// Nothing adjacent to the cache is left, continue with the next unemitted triangle
+			while (emitted[scanCursor])
+			{
+				scanCursor++;
+			}
+			best = static_cast<uint32_t>(scanCursor);
+		}
+
+		emitted[best] = true;
+		const GLuint* corners = &indices[best * 3];
+		for (int c = 0; c < 3; c++)
+		{
+			GLuint vertex = corners[c];
+			output.push_back(vertex);
+
+			// Drop the triangle from the vertex's live list
+			uint32_t* live = &adjacency[adjacencyOffset[vertex]];
+			for (uint32_t i = 0; i < liveCount[vertex]; i++)
+			{
+				if (live[i] == best)
+				{
+					std::swap(live[i], live[liveCount[vertex] - 1]);
+					liveCount[vertex]--;
+					break;
+				}
+			}
+		}
+
+		// Move the triangle's vertices to the front of the LRU cache
+		newCache.clear();
+		for (int c = 0; c < 3; c++)
+		{
+			if (std::find(newCache.begin(), newCache.end(), corners[c]) == newCache.end())
+			{
+				newCache.push_back(corners[c]);
+			}
+		}
+		for (GLuint vertex : cache)
+		{
+			if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+			{
+				newCache.push_back(vertex);
+			}
+		}
+
+		for (size_t i = 0; i < newCache.size(); i++)
+		{
+			cachePosition[newCache[i]] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+			updateVertexScore(newCache[i]);
+		}
+		if (newCache.size() > FORSYTH_CACHE_SIZE)
+		{
+			newCache.resize(FORSYTH_CACHE_SIZE);
+		}
+		std::swap(cache, newCache);
+
+		// Next triangle is the best one touching the cache
+		best = INVALID_INDEX;
+		float bestScore = -FLT_MAX;
+		for (GLuint vertex : cache)
+		{
+			for (uint32_t i = 0; i < liveCount[vertex]; i++)
+			{
+				uint32_t triangle = adjacency[adjacencyOffset[vertex] + i];
+				if (triangleScore[triangle] > bestScore)
+				{
+					bestScore = triangleScore[triangle];
+					best = triangle;
+				}
+			}
+		}
+	}
+
+	indices = std::move(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<GLuint>& indices, const std::vector<Vertex>& vertices, float threshold)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	// Cluster boundaries: hard ones where the cache restarts (all three corners miss), soft ones
+	// wherever the cluster so far is already within the threshold of the mesh's ACMR
+	const float targetACMR = AnalyzeVertexCache(indices, vertices.size()).ACMR() * threshold;
+
+	std::vector<size_t> clusterStarts;
+	FifoCache cache(vertices.size(), SIMULATED_CACHE_SIZE);
+	size_t clusterMisses = 0;
+	size_t clusterTriangles = 0;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		size_t misses = 0;
+		for (int c = 0; c < 3; c++)
+		{
+			misses += cache.Access(indices[t * 3 + c]) ? 1 : 0;
+		}
+
+		bool softBoundary = clusterTriangles > 0 && clusterMisses <= clusterTriangles * targetACMR;
+		if (t == 0 || misses == 3 || softBoundary)
+		{
+			clusterStarts.push_back(t);
+			clusterMisses = 0;
+			clusterTriangles = 0;
+		}
+		clusterMisses += misses;
+		clusterTriangles++;
+	}
+	clusterStarts.push_back(triangleCount);
+
+	const size_t clusterCount = clusterStarts.size() - 1;
+	if (clusterCount < 2)
+	{
+		return;
+	}
+
+	// Area weighted centroid and normal per cluster, and for the whole mesh
+	std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+	std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+	std::vector<float> clusterArea(clusterCount, 0.0f);
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	for (size_t cluster = 0; cluster < clusterCount; cluster++)
+	{
+		for (size_t t = clusterStarts[cluster]; t < clusterStarts[cluster + 1]; t++)
+		{
+			const glm::vec3& p0 = vertices[indices[t * 3]].position;
+			const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+			const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			glm::vec3 center = (p0 + p1 + p2) / 3.0f;
+
+			clusterCentroid[cluster] += center * area;
+			clusterNormal[cluster] += normal;
+			clusterArea[cluster] += area;
+		}
+
+		meshCentroid += clusterCentroid[cluster];
+		meshArea += clusterArea[cluster];
+		if (clusterArea[cluster] > 0.0f)
+		{
+			clusterCentroid[cluster] /= clusterArea[cluster];
+		}
+	}
+	if (meshArea > 0.0f)
+	{
+		meshCentroid /= meshArea;
+	}
+
+	// Clusters facing away from the mesh center are likely occluders, draw them first
+	std::vector<float> sortKey(clusterCount, 0.0f);
+	for (size_t cluster = 0; cluster < clusterCount; cluster++)
+	{
+		float normalLength = glm::length(clusterNormal[cluster]);
+		if (normalLength > 0.0f)
+		{
+			sortKey[cluster] = glm::dot(clusterCentroid[cluster] - meshCentroid, clusterNormal[cluster] / normalLength);
+		}
+	}
+
+	std::vector<size_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+	std::vector<GLuint> output;
+	output.reserve(indices.size());
+	for (size_t cluster : order)
+	{
+		output.insert(output.end(), indices.begin() + clusterStarts[cluster] * 3, indices.begin() + clusterStarts[cluster + 1] * 3);
+	}
+	indices = std::move(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<GLuint>& indices)
+{
+	// Renumber vertices in the order the index buffer first touches them, dropping unused ones
+	std::vector<GLuint> remap(vertices.size(), INVALID_INDEX);
+	std::vector<Vertex> ordered;
+	ordered.reserve(vertices.size());
+
+	for (GLuint& index : indices)
+	{
+		if (remap[index] == INVALID_INDEX)
+		{
+			remap[index] = static_cast<GLuint>(ordered.size());
+			ordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices = std::move(ordered);
+}
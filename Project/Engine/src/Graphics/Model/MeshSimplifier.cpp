@@ -0,0 +1,304 @@
+#include "pch.h"
+#include "Graphics/Model/MeshSimplifier.hpp"
+#include "Graphics/Bounds.hpp"
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+	// Symmetric 4x4 matrix of summed plane equations, stored as its upper triangle
+	struct Quadric {
+		double a2 = 0, ab = 0, ac = 0, ad = 0;
+		double b2 = 0, bc = 0, bd = 0;
+		double c2 = 0, cd = 0;
+		double d2 = 0;
+		double weight = 0;
+
+		void AddPlane(const glm::dvec3& n, double d, double weight)
+		{
+			a2 += weight * n.x * n.x; ab += weight * n.x * n.y; ac += weight * n.x * n.z; ad += weight * n.x * d;
+			b2 += weight * n.y * n.y; bc += weight * n.y * n.z; bd += weight * n.y * d;
+			c2 += weight * n.z * n.z; cd += weight * n.z * d;
+			d2 += weight * d * d;
+			this->weight += weight;
+		}
+
+		void Add(const Quadric& q)
+		{
+			a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+			b2 += q.b2; bc += q.bc; bd += q.bd;
+			c2 += q.c2; cd += q.cd;
+			d2 += q.d2;
+			weight += q.weight;
+		}
+
+		// Area weighted mean of the squared distances from p to the accumulated planes
+		double Evaluate(const glm::dvec3& p) const
+		{
+			if (weight <= 0.0)
+			{
+				return 0.0;
+			}
+
+			double result = a2 * p.x * p.x + 2 * ab * p.x * p.y + 2 * ac * p.x * p.z + 2 * ad * p.x
+				+ b2 * p.y * p.y + 2 * bc * p.y * p.z + 2 * bd * p.y
+				+ c2 * p.z * p.z + 2 * cd * p.z
+				+ d2;
+			return std::max(result, 0.0) / weight;
+		}
+	};
+
+	struct PositionHash {
+		size_t operator()(const glm::vec3& p) const
+		{
+			uint32_t bits[3];
+			std::memcpy(bits, &p, sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+
+	struct Collapse {
+		GLuint from;
+		GLuint to;
+		double cost;
+	};
+}
+
+float MeshSimplifier::Simplify(const std::vector<Vertex>& vertices, std::vector<GLuint>& indices, size_t targetIndexCount, float maxError)
+{
+	const size_t vertexCount = vertices.size();
+	if (indices.size() % 3 != 0 || indices.size() <= targetIndexCount)
+	{
+		return 0.0f;
+	}
+
+	AABB bounds;
+	for (const Vertex& vertex : vertices)
+	{
+		bounds.Expand(vertex.position);
+	}
+	const glm::vec3 size = bounds.max - bounds.min;
+	const double extent = std::max(std::max(size.x, size.y), std::max(size.z, 1e-6f));
+	const double maxCost = (maxError * extent) * (maxError * extent);
+
+	// Vertices sharing a position are one corner split by attributes
+	std::vector<uint32_t> positionGroup(vertexCount);
+	std::vector<uint32_t> groupSize;
+	{
+		std::unordered_map<glm::vec3, uint32_t, PositionHash> groups;
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			auto [it, inserted] = groups.emplace(vertices[v].position, static_cast<uint32_t>(groupSize.size()));
+			if (inserted)
+			{
+				groupSize.push_back(0);
+			}
+			positionGroup[v] = it->second;
+			groupSize[it->second]++;
+		}
+	}
+
+	// Seams, and edges used by one triangle (borders) or more than two (non-manifold), are locked
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::unordered_map<uint64_t, uint32_t> edgeUse;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				uint32_t a = positionGroup[indices[i + e]];
+				uint32_t b = positionGroup[indices[i + (e + 1) % 3]];
+				uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+				edgeUse[key]++;
+			}
+		}
+
+		std::vector<bool> lockedGroup(groupSize.size(), false);
+		for (const auto& [key, count] : edgeUse)
+		{
+			if (count != 2)
+			{
+				lockedGroup[static_cast<uint32_t>(key >> 32)] = true;
+				lockedGroup[static_cast<uint32_t>(key & 0xFFFFFFFFu)] = true;
+			}
+		}
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			locked[v] = groupSize[positionGroup[v]] > 1 || lockedGroup[positionGroup[v]];
+		}
+	}
+
+	// Each vertex starts with the planes of the triangles around it
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		glm::dvec3 p0 = vertices[indices[i]].position;
+		glm::dvec3 p1 = vertices[indices[i + 1]].position;
+		glm::dvec3 p2 = vertices[indices[i + 2]].position;
+
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		double area = glm::length(normal);
+		if (area <= 0.0)
+		{
+			continue;
+		}
+		normal /= area;
+
+		double d = -glm::dot(normal, p0);
+		for (int c = 0; c < 3; c++)
+		{
+			quadrics[indices[i + c]].AddPlane(normal, d, area);
+		}
+	}
+
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> adjacencyOffset(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<GLuint> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	double reachedCost = 0.0;
+
+	// Passes of independent collapses, cheapest first, until the target is met or nothing is left under the error limit
+	while (indices.size() > targetIndexCount)
+	{
+		const size_t triangleCount = indices.size() / 3;
+
+		std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0);
+		for (GLuint index : indices)
+		{
+			adjacencyOffset[index + 1]++;
+		}
+		std::partial_sum(adjacencyOffset.begin(), adjacencyOffset.end(), adjacencyOffset.begin());
+		adjacency.resize(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				GLuint a = indices[i + e];
+				GLuint b = indices[i + (e + 1) % 3];
+				for (int direction = 0; direction < 2; direction++)
+				{
+					GLuint from = direction == 0 ? a : b;
+					GLuint to = direction == 0 ? b : a;
+					if (locked[from])
+					{
+						continue;
+					}
+
+					Quadric combined = quadrics[from];
+					combined.Add(quadrics[to]);
+					double cost = combined.Evaluate(glm::dvec3(vertices[to].position));
+					if (cost <= maxCost)
+					{
+						collapses.push_back(Collapse{ from, to, cost });
+					}
+				}
+			}
+		}
+
+		if (collapses.empty())
+		{
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+		std::iota(remap.begin(), remap.end(), 0);
+		std::fill(touched.begin(), touched.end(), false);
+
+		size_t removedTriangles = 0;
+		size_t collapseCount = 0;
+		const size_t trianglesToRemove = triangleCount - targetIndexCount / 3;
+
+		for (const Collapse& collapse : collapses)
+		{
+			if (removedTriangles >= trianglesToRemove)
+			{
+				break;
+			}
+			if (touched[collapse.from] || touched[collapse.to])
+			{
+				continue;
+			}
+
+			// Reject the collapse if any surviving triangle around from would flip over
+			const glm::vec3& target = vertices[collapse.to].position;
+			bool rejected = false;
+			size_t collapsedTriangles = 0;
+			for (uint32_t i = adjacencyOffset[collapse.from]; i < adjacencyOffset[collapse.from + 1] && !rejected; i++)
+			{
+				const GLuint* triangle = &indices[adjacency[i] * 3];
+				if (touched[triangle[0]] || touched[triangle[1]] || touched[triangle[2]])
+				{
+					rejected = true; // Neighbourhood already changed this pass, retry in the next one
+					break;
+				}
+				if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+				{
+					collapsedTriangles++;
+					continue;
+				}
+
+				glm::vec3 before[3], after[3];
+				for (int c = 0; c < 3; c++)
+				{
+					before[c] = vertices[triangle[c]].position;
+					after[c] = triangle[c] == collapse.from ? target : before[c];
+				}
+				glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				rejected = glm::dot(normalBefore, normalAfter) <= 0.0f;
+			}
+			if (rejected)
+			{
+				continue;
+			}
+
+			// Lock the one-ring for the rest of the pass so the flip checks above stay valid
+			for (uint32_t i = adjacencyOffset[collapse.from]; i < adjacencyOffset[collapse.from + 1]; i++)
+			{
+				const GLuint* triangle = &indices[adjacency[i] * 3];
+				touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+			}
+
+			remap[collapse.from] = collapse.to;
+			quadrics[collapse.to].Add(quadrics[collapse.from]);
+			reachedCost = std::max(reachedCost, collapse.cost);
+			removedTriangles += collapsedTriangles;
+			collapseCount++;
+		}
+
+		if (collapseCount == 0)
+		{
+			break;
+		}
+
+		// Apply the collapses and drop triangles that became degenerate
+		size_t write = 0;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			GLuint a = remap[indices[i]];
+			GLuint b = remap[indices[i + 1]];
+			GLuint c = remap[indices[i + 2]];
+			if (a == b || b == c || c == a)
+			{
+				continue;
+			}
+			indices[write++] = a;
+			indices[write++] = b;
+			indices[write++] = c;
+		}
+		indices.resize(write);
+	}
+
+	return static_cast<float>(std::sqrt(reachedCost) / extent);
+}
@@ -1,9 +1,46 @@
 #include "pch.h"
 #include "Graphics/Model/Model.h"
 #include "Graphics/TextureManager.h"
+#include "Graphics/Model/MeshOptimizer.hpp"
+#include "Graphics/Model/MeshSimplifier.hpp"
 #include <iostream>
+#include <fstream>
+#include <filesystem>
 #include "Asset Manager/AssetManager.hpp"
 
+namespace {
+	constexpr uint32_t COOKED_MAGIC = 0x48534D47; // "GMSH"
+
+	template <typename T>
+	bool ReadArray(std::ifstream& file, std::vector<T>& data)
+	{
+		uint32_t count = 0;
+		file.read(reinterpret_cast<char*>(&count), sizeof(count));
+		if (!file)
+		{
+			return false;
+		}
+		data.resize(count);
+		file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(count * sizeof(T)));
+		return static_cast<bool>(file);
+	}
+
+	template <typename T>
+	void WriteArray(std::ofstream& file, const std::vector<T>& data)
+	{
+		uint32_t count = static_cast<uint32_t>(data.size());
+		file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(count * sizeof(T)));
+	}
+
+	int64_t GetSourceTimestamp(const std::string& path)
+	{
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(path, error);
+		return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+	}
+}
+
 bool Model::LoadAsset(const std::string& path) 
 {
 	Assimp::Importer importer;
@@ -20,38 +57,227 @@ bool Model::LoadAsset(const std::string& path)
 	directory = path.substr(0, path.find_last_of('/'));
 
 	// Recursive function
-	processNode(scene->mRootNode, scene);
+	std::vector<aiMesh*> sourceMeshes;
+	processNode(scene->mRootNode, scene, sourceMeshes);
+
+	// Vertex welding and reordering is done once and baked into the cooked file
+	std::vector<MeshGeometry> geometry;
+	if (!loadCookedGeometry(path, sourceMeshes.size(), geometry))
+	{
+		geometry.assign(sourceMeshes.size(), MeshGeometry());
+		MeshOptimizer::Report total;
+		for (size_t i = 0; i < sourceMeshes.size(); i++)
+		{
+			extractGeometry(sourceMeshes[i], geometry[i]);
+			MeshOptimizer::Report report = MeshOptimizer::Optimize(geometry[i].vertices, geometry[i].indices);
+			total.sourceVertices += report.sourceVertices;
+			total.optimizedVertices += report.optimizedVertices;
+			total.before.Add(report.before);
+			total.after.Add(report.after);
+
+			generateLODs(geometry[i]);
+		}
+
+		std::cout << "[Model] Optimized " << path << ": vertices " << total.sourceVertices << " -> " << total.optimizedVertices
+			<< ", ACMR " << total.before.ACMR() << " -> " << total.after.ACMR()
+			<< ", ATVR " << total.before.ATVR() << " -> " << total.after.ATVR() << std::endl;
+
+		size_t lodTriangles[Mesh::MAX_LODS] = {};
+		for (const MeshGeometry& mesh : geometry)
+		{
+			lodTriangles[0] += mesh.indices.size() / 3;
+			for (size_t level = 0; level < mesh.lods.size(); level++)
+			{
+				lodTriangles[level + 1] += mesh.lods[level].indices.size() / 3;
+			}
+		}
+		std::cout << "[Model] LOD triangles:";
+		for (size_t level = 0; level < Mesh::MAX_LODS && lodTriangles[level] > 0; level++)
+		{
+			std::cout << " " << lodTriangles[level];
+		}
+		std::cout << std::endl;
+
+		saveCookedGeometry(path, geometry);
+	}
+
+	meshes.reserve(sourceMeshes.size());
+	for (size_t i = 0; i < sourceMeshes.size(); i++)
+	{
+		Mesh& mesh = meshes.emplace_back(processMesh(sourceMeshes[i], scene, geometry[i]));
+		for (const LODGeometry& lod : geometry[i].lods)
+		{
+			mesh.AddLOD(lod.vertices, lod.indices, lod.error);
+		}
+		lodCount = std::max(lodCount, mesh.GetLODCount());
+	}
+
+	computeBounds();
+	triangleBVH.Build(meshes);
+
+	return true;
+}
+
+bool Model::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleRayHit& hit) const
+{
+	return triangleBVH.Raycast(origin, direction, maxDistance, hit);
+}
+
+void Model::computeBounds()
+{
+	localBounds = AABB();
+	for (const Mesh& mesh : meshes)
+	{
+		localBounds.Expand(mesh.localBounds);
+	}
+
+	if (!localBounds.IsValid())
+	{
+		localSphere = BoundingSphere();
+		return;
+	}
+
+	// Enclose every mesh sphere around the combined box center
+	glm::vec3 center = localBounds.Center();
+	float radius = 0.0f;
+	for (const Mesh& mesh : meshes)
+	{
+		radius = std::max(radius, glm::length(mesh.localSphere.center - center) + mesh.localSphere.radius);
+	}
+	localSphere = BoundingSphere(center, radius);
+}
+
+bool Model::loadCookedGeometry(const std::string& path, size_t meshCount, std::vector<MeshGeometry>& geometry)
+{
+	std::ifstream file(path + ".cooked", std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	uint32_t magic = 0, version = 0, count = 0;
+	int64_t timestamp = 0;
+	file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
+	file.read(reinterpret_cast<char*>(&count), sizeof(count));
+	if (!file || magic != COOKED_MAGIC || version != COOKED_VERSION || timestamp != GetSourceTimestamp(path) || count != meshCount)
+	{
+		return false;
+	}
+
+	geometry.assign(meshCount, MeshGeometry());
+	for (MeshGeometry& mesh : geometry)
+	{
+		uint32_t lodCount = 0;
+		bool valid = ReadArray(file, mesh.vertices) && ReadArray(file, mesh.indices);
+		file.read(reinterpret_cast<char*>(&lodCount), sizeof(lodCount));
+		valid = valid && file && lodCount < Mesh::MAX_LODS;
+
+		for (uint32_t i = 0; valid && i < lodCount; i++)
+		{
+			LODGeometry& lod = mesh.lods.emplace_back();
+			valid = ReadArray(file, lod.vertices) && ReadArray(file, lod.indices);
+			file.read(reinterpret_cast<char*>(&lod.error), sizeof(lod.error));
+			valid = valid && file;
+		}
+
+		if (!valid)
+		{
+			std::cerr << "[Model] Cooked geometry is truncated, rebuilding: " << path << std::endl;
+			return false;
+		}
+	}
 
 	return true;
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+void Model::saveCookedGeometry(const std::string& path, const std::vector<MeshGeometry>& geometry)
 {
-	// Process each mesh in this node
+	std::ofstream file(path + ".cooked", std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cerr << "[Model] Could not write cooked geometry for: " << path << std::endl;
+		return;
+	}
+
+	uint32_t magic = COOKED_MAGIC, version = COOKED_VERSION, count = static_cast<uint32_t>(geometry.size());
+	int64_t timestamp = GetSourceTimestamp(path);
+	file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+	for (const MeshGeometry& mesh : geometry)
+	{
+		WriteArray(file, mesh.vertices);
+		WriteArray(file, mesh.indices);
+
+		uint32_t lodCount = static_cast<uint32_t>(mesh.lods.size());
+		file.write(reinterpret_cast<const char*>(&lodCount), sizeof(lodCount));
+		for (const LODGeometry& lod : mesh.lods)
+		{
+			WriteArray(file, lod.vertices);
+			WriteArray(file, lod.indices);
+			file.write(reinterpret_cast<const char*>(&lod.error), sizeof(lod.error));
+		}
+	}
+}
+
+void Model::generateLODs(MeshGeometry& geometry)
+{
+	// Each level simplifies the previous one to half its triangles, and is only kept if it got reasonably close
+	std::vector<GLuint> indices = geometry.indices;
+	for (uint32_t level = 1; level < Mesh::MAX_LODS; level++)
+	{
+		size_t previousTriangles = indices.size() / 3;
+		size_t targetTriangles = previousTriangles / 2;
+		if (targetTriangles < MIN_LOD_TRIANGLES)
+		{
+			break;
+		}
+
+		float error = MeshSimplifier::Simplify(geometry.vertices, indices, targetTriangles * 3, MAX_LOD_ERROR);
+		if (indices.size() / 3 > previousTriangles * 3 / 4)
+		{
+			break;
+		}
+
+		LODGeometry& lod = geometry.lods.emplace_back();
+		lod.vertices = geometry.vertices;
+		lod.indices = indices;
+		lod.error = error;
+		MeshOptimizer::OptimizeVertexCache(lod.indices, lod.vertices.size());
+		MeshOptimizer::OptimizeVertexFetch(lod.vertices, lod.indices);
+	}
+}
+
+void Model::processNode(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& sourceMeshes)
+{
+	// Collect each mesh in this node
 	for (unsigned int i = 0; i < node->mNumMeshes; i++)
 	{
-		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		meshes.emplace_back(processMesh(mesh, scene));
+		sourceMeshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 	}
 
 	// Process children nodes
 	for (unsigned int i = 0; i < node->mNumChildren; i++)
 	{
-		processNode(node->mChildren[i], scene);
+		processNode(node->mChildren[i], scene, sourceMeshes);
 	}
 
 }
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+void Model::extractGeometry(aiMesh* mesh, MeshGeometry& geometry)
 {
-    std::vector<Vertex> vertices;
-    std::vector<GLuint> indices;
-    std::vector<std::shared_ptr<Texture>> textures;
+    std::vector<Vertex>& vertices = geometry.vertices;
+    std::vector<GLuint>& indices = geometry.indices;
 
     // Process vertices (same as before)
     for (unsigned int i = 0; i < mesh->mNumVertices; i++)
     {
-        Vertex vertex;
+        // Zero initialised so missing attributes weld consistently
+        Vertex vertex{};
 
         // Position
         vertex.position.x = mesh->mVertices[i].x;
@@ -77,7 +303,6 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
             vertex.texUV = glm::vec2(0.f, 0.f);
         }
 
-        vertex.color = glm::vec3(1.0f, 1.0f, 1.0f);
         vertices.push_back(vertex);
     }
 
@@ -90,6 +315,11 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
             indices.push_back(face.mIndices[j]);
         }
     }
+}
+
+Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene, MeshGeometry& geometry)
+{
+    std::vector<std::shared_ptr<Texture>> textures;
 
     // Create material from Assimp material
     std::shared_ptr<Material> material = nullptr;
@@ -182,7 +412,7 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
         material = Material::createDefault();
     }
 
-    return Mesh(vertices, indices, material);
+    return Mesh(geometry.vertices, geometry.indices, material);
 }
 
 std::vector<std::shared_ptr<Texture>> Model::loadMaterialTexture(aiMaterial* mat, aiTextureType type, std::string typeName)
@@ -209,10 +439,10 @@ std::vector<std::shared_ptr<Texture>> Model::loadMaterialTexture(aiMaterial* mat
 	return textures;
 }
 
-void Model::Draw(Shader& shader, const Camera& camera)
+void Model::Draw(Shader& shader)
 {
 	for (auto& mesh : meshes)
 	{
-		mesh.Draw(shader, camera);
+		mesh.Draw(shader);
 	}
 }
\ No newline at end of file
@@ -5,35 +5,86 @@
 #include <Graphics/Model/ModelRenderComponent.hpp>
 #include "WindowManager.hpp"
 #include "Graphics/GraphicsManager.hpp"
+#include "Graphics/RenderThread.hpp"
 #include <Transform/TransformComponent.hpp>
 
 bool ModelSystem::Initialise() 
 {
+    BuildStaticBatches();
     std::cout << "[ModelSystem] Initialized" << std::endl;
     return true;
 }
 
-void ModelSystem::Update() 
+void ModelSystem::BuildStaticBatches()
 {
     ECSManager& ecsManager = ECSRegistry::GetInstance().GetActiveECSManager();
-    GraphicsManager& gfxManager = GraphicsManager::GetInstance();
+    staticBatcher.Build(ecsManager, entities);
+}
+
+void ModelSystem::Extract(RenderWorld& world)
+{
+    ECSManager& ecsManager = ECSRegistry::GetInstance().GetActiveECSManager();
+
+    if (staticBatcher.NeedsRebuild(ecsManager, entities))
+    {
+        // Rebuilding replaces buffers that frames still in flight may draw from
+        RenderThread::ContextScope context;
+        staticBatcher.Build(ecsManager, entities);
+    }
+    world.staticBatcher = &staticBatcher;
+
+    // Refitted once per frame, views query it to narrow down what they cull
+    if (ecsManager.spatialIndexSystem)
+    {
+        ecsManager.spatialIndexSystem->Update();
+        world.spatialIndex = ecsManager.spatialIndexSystem.get();
+    }
 
-    // Submit all visible models to the graphics manager
-    for (const auto& entity : entities) 
+    for (const auto& entity : entities)
     {
+        // Drawn as part of a static batch
+        if (staticBatcher.IsBatched(entity))
+        {
+            continue;
+        }
+
         auto& modelComponent = ecsManager.GetComponent<ModelRenderComponent>(entity);
 
         if (modelComponent.isVisible && modelComponent.model && modelComponent.shader) 
         {
-            gfxManager.SubmitModel(
-                modelComponent.model,
-                modelComponent.shader,
-                ecsManager.GetComponent<Transform>(entity).model
-            );
+            world.instanceOf[entity] = static_cast<uint32_t>(world.models.size());
+
+            RenderWorld::ModelInstance& instance = world.models.emplace_back();
+            instance.entity = entity;
+            instance.model = modelComponent.model;
+            instance.shader = modelComponent.shader;
+            instance.transform = GraphicsManager::ConvertMatrix4x4ToGLM(ecsManager.GetComponent<Transform>(entity).model);
+            instance.worldSphere = modelComponent.model->localSphere.Transformed(instance.transform);
+            instance.worldBounds = modelComponent.model->localBounds.Transformed(instance.transform);
+            instance.renderOrder = modelComponent.renderOrder;
         }
     }
 }
 
+uint32_t ModelSystem::SelectLOD(float screenCoverage, uint32_t currentLOD, uint32_t lodCount)
+{
+    uint32_t lod = std::min(currentLOD, lodCount - 1);
+
+    // Coarser while clearly below the threshold of the current level
+    while (lod + 1 < lodCount && screenCoverage < LOD_SCREEN_COVERAGE[lod] * (1.0f - LOD_HYSTERESIS))
+    {
+        lod++;
+    }
+
+    // Finer while clearly above the threshold that led to the current level
+    while (lod > 0 && screenCoverage > LOD_SCREEN_COVERAGE[lod - 1] * (1.0f + LOD_HYSTERESIS))
+    {
+        lod--;
+    }
+
+    return lod;
+}
+
 void ModelSystem::Shutdown() 
 {
     std::cout << "[ModelSystem] Shutdown" << std::endl;
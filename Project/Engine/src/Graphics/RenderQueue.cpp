@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "Graphics/RenderQueue.hpp"
+
+namespace RenderSortKey {
+	uint32_t QuantizeDepth(float depth01)
+	{
+		const uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+		float clamped = std::clamp(depth01, 0.0f, 1.0f);
+		return static_cast<uint32_t>(clamped * static_cast<float>(maxDepth));
+	}
+
+	uint64_t MakeOpaque(uint32_t layer, uint32_t program, uint32_t material, uint32_t mesh, uint32_t lod, float depth01)
+	{
+		assert(lod < (1u << LOD_BITS) && "LOD does not fit the sort key");
+
+		uint64_t key = std::min(layer, MAX_LAYER);
+		key = (key << 1) | 0u;
+		key = (key << PROGRAM_BITS) | (program & ((1u << PROGRAM_BITS) - 1));
+		key = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+		key = (key << MESH_BITS) | (mesh & ((1u << MESH_BITS) - 1));
+		key = (key << LOD_BITS) | (lod & ((1u << LOD_BITS) - 1));
+		key = (key << DEPTH_BITS) | QuantizeDepth(depth01);
+		return key;
+	}
+
+	uint64_t MakeTransparent(uint32_t layer, uint32_t program, uint32_t material, uint32_t mesh, uint32_t lod, float depth01)
+	{
+		assert(lod < (1u << LOD_BITS) && "LOD does not fit the sort key");
+
+		const uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+
+		uint64_t key = std::min(layer, MAX_LAYER);
+		key = (key << 1) | 1u;
+		// Invert depth so that the farthest packets sort first
+		key = (key << DEPTH_BITS) | (maxDepth - QuantizeDepth(depth01));
+		key = (key << PROGRAM_BITS) | (program & ((1u << PROGRAM_BITS) - 1));
+		key = (key << MATERIAL_BITS) | (material & ((1u << MATERIAL_BITS) - 1));
+		key = (key << MESH_BITS) | (mesh & ((1u << MESH_BITS) - 1));
+		key = (key << LOD_BITS) | (lod & ((1u << LOD_BITS) - 1));
+		return key;
+	}
+}
+
+void RenderQueue::Clear()
+{
+	packets.clear();
+	entries.clear();
+}
+
+DrawPacket& RenderQueue::Add()
+{
+	packets.emplace_back();
+	return packets.back();
+}
+
+void RenderQueue::Append(const std::vector<DrawPacket>& slice)
+{
+	packets.insert(packets.end(), slice.begin(), slice.end());
+}
+
+void RenderQueue::Sort()
+{
+	const size_t count = packets.size();
+	entries.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		entries[i] = { packets[i].sortKey, static_cast<uint32_t>(i) };
+	}
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	// Build all eight byte histograms in a single read of the keys
+	constexpr int PASSES = sizeof(uint64_t);
+	uint32_t histograms[PASSES][256] = {};
+	for (const SortEntry& entry : entries)
+	{
+		for (int pass = 0; pass < PASSES; ++pass)
+		{
+			histograms[pass][(entry.key >> (pass * 8)) & 0xFF]++;
+		}
+	}
+
+	scratch.resize(count);
+	SortEntry* src = entries.data();
+	SortEntry* dst = scratch.data();
+
+	for (int pass = 0; pass < PASSES; ++pass)
+	{
+		const int shift = pass * 8;
+		uint32_t* histogram = histograms[pass];
+
+		// Every key shares this byte, so the pass would not change the order
+		if (histogram[(src[0].key >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		// Convert counts into starting offsets
+		uint32_t offset = 0;
+		for (int bucket = 0; bucket < 256; ++bucket)
+		{
+			uint32_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+		}
+
+		std::swap(src, dst);
+	}
+
+	// An odd number of executed passes leaves the result in the scratch buffer
+	if (src != entries.data())
+	{
+		entries.swap(scratch);
+	}
+}
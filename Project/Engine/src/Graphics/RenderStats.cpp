@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "Graphics/RenderStats.hpp"
+
+RenderStats& RenderStats::GetInstance()
+{
+	static RenderStats instance;
+	return instance;
+}
+
+void RenderStats::BeginFrame()
+{
+	{
+		std::lock_guard<std::mutex> lock(historyMutex);
+		history[historyNext] = current;
+		historyNext = (historyNext + 1) % HISTORY_SIZE;
+		historyCount = std::min(historyCount + 1, HISTORY_SIZE);
+	}
+	current = Counters{};
+}
+
+RenderStats::Counters RenderStats::GetLastFrame() const
+{
+	std::lock_guard<std::mutex> lock(historyMutex);
+	if (historyCount == 0)
+	{
+		return Counters{};
+	}
+	return history[(historyNext + HISTORY_SIZE - 1) % HISTORY_SIZE];
+}
+
+std::vector<RenderStats::Counters> RenderStats::GetHistory() const
+{
+	std::lock_guard<std::mutex> lock(historyMutex);
+	std::vector<Counters> frames;
+	frames.reserve(historyCount);
+	for (uint32_t i = 0; i < historyCount; i++)
+	{
+		frames.push_back(history[(historyNext + HISTORY_SIZE - historyCount + i) % HISTORY_SIZE]);
+	}
+	return frames;
+}
@@ -29,7 +29,7 @@ void RenderSystem::applyLighting(Shader& shader)
 
     // Apply point lights
     const auto& pointLights = lightManager.getPointLights();
-    for (size_t i = 0; i < pointLights.size() && i < 4; i++) {
+    for (size_t i = 0; i < pointLights.size(); i++) {
         std::string base = "pointLights[" + std::to_string(i) + "]";
         shader.setVec3(base + ".position", pointLights[i].position);
         shader.setVec3(base + ".ambient", pointLights[i].ambient);
@@ -116,7 +116,7 @@ void RenderSystem::Render()
 			applyLighting(*renderer.shader);
         }
 
-		renderer.model->Draw(*renderer.shader, *currentCamera);
+		renderer.model->Draw(*renderer.shader);
 	}
 
    // for (const auto& item : renderQueue)
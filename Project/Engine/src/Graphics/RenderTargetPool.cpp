@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "Graphics/RenderTargetPool.hpp"
+#include "Graphics/GLStateCache.hpp"
+
+RenderTargetPool& RenderTargetPool::GetInstance()
+{
+	static RenderTargetPool instance;
+	return instance;
+}
+
+void RenderTargetPool::BeginFrame()
+{
+	frameNumber++;
+
+	for (auto it = targets.begin(); it != targets.end();)
+	{
+		RenderTarget& target = **it;
+		if (!target.inUse && frameNumber - target.lastUsedFrame > EVICT_FRAMES)
+		{
+			DestroyTarget(target);
+			it = targets.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void RenderTargetPool::Shutdown()
+{
+	for (auto& target : targets)
+	{
+		DestroyTarget(*target);
+	}
+	targets.clear();
+	framebuffers.clear();
+}
+
+RenderTarget* RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+{
+	const int width = std::max(desc.width, 1);
+	const int height = std::max(desc.height, 1);
+	const float maxArea = static_cast<float>(RoundUpSize(width)) * static_cast<float>(RoundUpSize(height)) * MAX_AREA_RATIO;
+
+	// Smallest free target that fits without wasting too much
+	RenderTarget* best = nullptr;
+	float bestArea = 0.0f;
+	for (auto& target : targets)
+	{
+		if (target->inUse || target->format != desc.format || target->width < width || target->height < height)
+		{
+			continue;
+		}
+
+		float area = static_cast<float>(target->width) * static_cast<float>(target->height);
+		if (area <= maxArea && (!best || area < bestArea))
+		{
+			best = target.get();
+			bestArea = area;
+		}
+	}
+
+	if (!best)
+	{
+		auto target = std::make_unique<RenderTarget>();
+		target->width = RoundUpSize(width);
+		target->height = RoundUpSize(height);
+		target->format = desc.format;
+		CreateTexture(*target);
+		best = targets.emplace_back(std::move(target)).get();
+	}
+
+	best->inUse = true;
+	best->lastUsedFrame = frameNumber;
+	return best;
+}
+
+void RenderTargetPool::Release(RenderTarget* target)
+{
+	if (target)
+	{
+		target->inUse = false;
+		target->lastUsedFrame = frameNumber;
+	}
+}
+
+GLuint RenderTargetPool::GetFramebuffer(const RenderTarget* color, const RenderTarget* depth)
+{
+	GLuint colorTexture = color ? color->texture : 0;
+	GLuint depthTexture = depth ? depth->texture : 0;
+
+	for (const FramebufferEntry& entry : framebuffers)
+	{
+		if (entry.color == colorTexture && entry.depth == depthTexture)
+		{
+			return entry.framebuffer;
+		}
+	}
+
+	FramebufferEntry entry{ colorTexture, depthTexture, 0 };
+	glGenFramebuffers(1, &entry.framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, entry.framebuffer);
+
+	if (color)
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+	}
+	else
+	{
+		// Depth only
+		GLenum none = GL_NONE;
+		glDrawBuffers(1, &none);
+		glReadBuffer(GL_NONE);
+	}
+	if (depth)
+	{
+		GLenum attachment = depth->format == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+		glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, depthTexture, 0);
+	}
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cerr << "[RenderTargetPool] Framebuffer not complete!" << std::endl;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	framebuffers.push_back(entry);
+	return entry.framebuffer;
+}
+
+bool RenderTargetPool::IsDepthFormat(GLenum format)
+{
+	return format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH24_STENCIL8;
+}
+
+int RenderTargetPool::RoundUpSize(int size)
+{
+	return (size + SIZE_GRANULARITY - 1) / SIZE_GRANULARITY * SIZE_GRANULARITY;
+}
+
+void RenderTargetPool::CreateTexture(RenderTarget& target)
+{
+	// GLES wants the exact upload format and type that matches each sized format
+	GLenum pixelFormat = GL_RGBA;
+	GLenum pixelType = GL_UNSIGNED_BYTE;
+	switch (target.format)
+	{
+	case GL_DEPTH_COMPONENT16:
+		pixelFormat = GL_DEPTH_COMPONENT;
+		pixelType = GL_UNSIGNED_SHORT;
+		break;
+	case GL_DEPTH_COMPONENT24:
+		pixelFormat = GL_DEPTH_COMPONENT;
+		pixelType = GL_UNSIGNED_INT;
+		break;
+	case GL_DEPTH_COMPONENT32F:
+		pixelFormat = GL_DEPTH_COMPONENT;
+		pixelType = GL_FLOAT;
+		break;
+	case GL_DEPTH24_STENCIL8:
+		pixelFormat = GL_DEPTH_STENCIL;
+		pixelType = GL_UNSIGNED_INT_24_8;
+		break;
+	case GL_RGBA16F:
+		pixelType = GL_HALF_FLOAT;
+		break;
+	default:
+		break;
+	}
+
+	// Depth can't be filtered linearly on GLES
+	GLint filter = IsDepthFormat(target.format) ? GL_NEAREST : GL_LINEAR;
+
+	glGenTextures(1, &target.texture);
+	GLStateCache::GetInstance().BindTexture(0, target.texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, target.format, target.width, target.height, 0, pixelFormat, pixelType, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	std::cout << "[RenderTargetPool] Created " << target.width << "x" << target.height << " target" << std::endl;
+}
+
+void RenderTargetPool::DestroyTarget(RenderTarget& target)
+{
+	// Framebuffers using the texture go with it
+	for (auto it = framebuffers.begin(); it != framebuffers.end();)
+	{
+		if (it->color == target.texture || it->depth == target.texture)
+		{
+			glDeleteFramebuffers(1, &it->framebuffer);
+			it = framebuffers.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	if (target.texture != 0)
+	{
+		glDeleteTextures(1, &target.texture);
+		GLStateCache::GetInstance().OnTextureDeleted(target.texture);
+		target.texture = 0;
+	}
+}
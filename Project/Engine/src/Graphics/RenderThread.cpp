@@ -0,0 +1,192 @@
+#include "pch.h"
+#include "Graphics/RenderThread.hpp"
+#include "Graphics/GraphicsManager.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/RenderStats.hpp"
+#include "WindowManager.hpp"
+
+RenderThread& RenderThread::GetInstance()
+{
+	static RenderThread instance;
+	return instance;
+}
+
+void RenderThread::Start()
+{
+	if (running)
+	{
+		return;
+	}
+
+	// A context can only be current on one thread at a time
+	WindowManager::ReleaseContext();
+
+	writeIndex = 0;
+	readIndex = 0;
+	publishedCount = 0;
+	recording = false;
+	stopRequested = false;
+	contextRequested = false;
+	contextLent = false;
+	running = true;
+	thread = std::thread(&RenderThread::ThreadLoop, this);
+
+	std::cout << "[RenderThread] Started with " << FRAME_SLOTS << " frame slots" << std::endl;
+}
+
+void RenderThread::Stop()
+{
+	if (!running)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopRequested = true;
+	}
+	condition.notify_all();
+	thread.join();
+	running = false;
+
+	// Resources are released from the main thread after this
+	WindowManager::MakeContextCurrent();
+
+	for (RenderFrame& frame : frames)
+	{
+		frame.Reset();
+	}
+	std::cout << "[RenderThread] Stopped" << std::endl;
+}
+
+RenderFrame& RenderThread::AcquireFrame()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		condition.wait(lock, [this] { return recording || publishedCount < FRAME_SLOTS; });
+		recording = true;
+	}
+
+	// The slot is out of the render thread's reach until it's published again
+	RenderFrame& frame = frames[writeIndex];
+	frame.Reset();
+	return frame;
+}
+
+void RenderThread::PublishFrame()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!recording)
+		{
+			return;
+		}
+		recording = false;
+		writeIndex = (writeIndex + 1) % FRAME_SLOTS;
+		publishedCount++;
+	}
+	condition.notify_all();
+}
+
+void RenderThread::Flush()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this] { return publishedCount == 0; });
+}
+
+void RenderThread::ThreadLoop()
+{
+	WindowManager::MakeContextCurrent();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		condition.wait(lock, [this] { return stopRequested || contextRequested || publishedCount > 0; });
+
+		if (contextRequested)
+		{
+			// Hand the context to the main thread and wait for it to come back
+			WindowManager::ReleaseContext();
+			contextLent = true;
+			condition.notify_all();
+			condition.wait(lock, [this] { return !contextRequested; });
+			contextLent = false;
+			WindowManager::MakeContextCurrent();
+			continue;
+		}
+
+		// Only stops once everything published has been drawn
+		if (publishedCount == 0)
+		{
+			break;
+		}
+
+		RenderFrame& frame = frames[readIndex];
+		lock.unlock();
+		DrawFrame(frame);
+		lock.lock();
+
+		readIndex = (readIndex + 1) % FRAME_SLOTS;
+		publishedCount--;
+		condition.notify_all();
+	}
+	lock.unlock();
+
+	WindowManager::ReleaseContext();
+}
+
+void RenderThread::DrawFrame(RenderFrame& frame)
+{
+	GLStateCache::GetInstance().BeginFrame();
+	RenderStats::GetInstance().BeginFrame();
+
+	// The window may have been resized since the last frame, the main thread can't set the viewport itself
+	if (frame.hasView)
+	{
+		glViewport(0, 0, frame.view.viewportWidth, frame.view.viewportHeight);
+	}
+
+	GraphicsManager::GetInstance().ExecuteFrame(frame);
+	WindowManager::SwapBuffers();
+}
+
+void RenderThread::BorrowContext()
+{
+	// Nothing in flight may still reference resources the caller is about to replace
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, [this] { return publishedCount == 0; });
+	contextRequested = true;
+	condition.notify_all();
+	condition.wait(lock, [this] { return contextLent; });
+	lock.unlock();
+
+	WindowManager::MakeContextCurrent();
+}
+
+void RenderThread::ReturnContext()
+{
+	WindowManager::ReleaseContext();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		contextRequested = false;
+	}
+	condition.notify_all();
+}
+
+RenderThread::ContextScope::ContextScope()
+{
+	RenderThread& renderThread = RenderThread::GetInstance();
+	if (renderThread.IsRunning())
+	{
+		renderThread.BorrowContext();
+		borrowed = true;
+	}
+}
+
+RenderThread::ContextScope::~ContextScope()
+{
+	if (borrowed)
+	{
+		RenderThread::GetInstance().ReturnContext();
+	}
+}
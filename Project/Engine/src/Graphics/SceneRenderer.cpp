@@ -4,77 +4,45 @@
 #include "Engine.h"
 #include "ECS/ECSRegistry.hpp"
 #include "Graphics/GraphicsManager.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/RenderTargetPool.hpp"
+#include "Graphics/DynamicResolution.hpp"
 #include "Scene/SceneManager.hpp"
 #include "Scene/SceneInstance.hpp"
 #include "WindowManager.hpp"
 #include <iostream>
 
 // Static member definitions
-unsigned int SceneRenderer::sceneFrameBuffer = 0;
-unsigned int SceneRenderer::sceneColorTexture = 0;
-unsigned int SceneRenderer::sceneDepthTexture = 0;
-int SceneRenderer::sceneWidth = 1280;
-int SceneRenderer::sceneHeight = 720;
+FrameGraph SceneRenderer::frameGraph;
+SceneRenderer::ViewState SceneRenderer::views[static_cast<int>(SceneRenderer::View::Count)];
 Camera* SceneRenderer::editorCamera = nullptr;
 
-unsigned int SceneRenderer::CreateSceneFramebuffer(int width, int height)
+void SceneRenderer::BeginFrame()
 {
-    // Delete existing framebuffer if it exists
-    if (sceneFrameBuffer != 0) {
-        DeleteSceneFramebuffer();
+    RenderTargetPool& pool = RenderTargetPool::GetInstance();
+    pool.BeginFrame();
+
+    // The UI drew last frame's views already, their targets can be reused
+    frameGraph.Clear();
+    for (ViewState& view : views) {
+        pool.Release(view.target);
+        view = ViewState{};
     }
+}
 
-    sceneWidth = width;
-    sceneHeight = height;
-
-    // Generate framebuffer
-    glGenFramebuffers(1, &sceneFrameBuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, sceneFrameBuffer);
-
-    // Create color texture
-    glGenTextures(1, &sceneColorTexture);
-    glBindTexture(GL_TEXTURE_2D, sceneColorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneColorTexture, 0);
-
-    // Create depth texture
-    glGenTextures(1, &sceneDepthTexture);
-    glBindTexture(GL_TEXTURE_2D, sceneDepthTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, sceneDepthTexture, 0);
-
-    // Check framebuffer completeness
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "SceneRenderer: Framebuffer not complete!" << std::endl;
-    }
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    return sceneFrameBuffer;
+void SceneRenderer::ExecuteFrame()
+{
+    frameGraph.Execute();
 }
 
-void SceneRenderer::DeleteSceneFramebuffer()
+void SceneRenderer::Shutdown()
 {
-    if (sceneColorTexture != 0) {
-        glDeleteTextures(1, &sceneColorTexture);
-        sceneColorTexture = 0;
-    }
-    if (sceneDepthTexture != 0) {
-        glDeleteTextures(1, &sceneDepthTexture);
-        sceneDepthTexture = 0;
-    }
-    if (sceneFrameBuffer != 0) {
-        glDeleteFramebuffers(1, &sceneFrameBuffer);
-        sceneFrameBuffer = 0;
+    frameGraph.Clear();
+    for (ViewState& view : views) {
+        view = ViewState{};
     }
+    RenderTargetPool::GetInstance().Shutdown();
+    DynamicResolution::GetInstance().Shutdown();
 
     // Clean up editor camera
     if (editorCamera) {
@@ -84,39 +52,111 @@ void SceneRenderer::DeleteSceneFramebuffer()
     }
 }
 
-unsigned int SceneRenderer::GetSceneTexture()
+void SceneRenderer::AddGameViewPass(int width, int height, bool toBackbuffer)
+{
+    AddViewPass(View::Game, width, height, toBackbuffer, []() {
+        RenderScene();
+    });
+}
+
+void SceneRenderer::AddEditorViewPass(int width, int height, const glm::vec3& cameraPos, const glm::vec3& cameraFront, const glm::vec3& cameraUp, float cameraZoom)
 {
-    return sceneColorTexture;
+    AddViewPass(View::Editor, width, height, false, [cameraPos, cameraFront, cameraUp, cameraZoom]() {
+        RenderSceneForEditor(cameraPos, cameraFront, cameraUp, cameraZoom);
+    });
 }
 
-void SceneRenderer::BeginSceneRender(int width, int height)
+void SceneRenderer::AddViewPass(View view, int width, int height, bool toBackbuffer, std::function<void()> draw)
 {
-    // Create or resize framebuffer if needed
-    if (sceneFrameBuffer == 0 || width != sceneWidth || height != sceneHeight) {
-        CreateSceneFramebuffer(width, height);
+    RenderTargetPool& pool = RenderTargetPool::GetInstance();
+    ViewState& state = views[static_cast<int>(view)];
+
+    // Sizes change every frame while a panel is dragged, the pool only reallocates once they change a lot
+    pool.Release(state.target);
+    state.target = toBackbuffer ? nullptr : pool.Acquire(RenderTargetDesc{ width, height, GL_RGBA8 });
+    state.width = width;
+    state.height = height;
+
+    // Only the game view follows the dynamic resolution scale, the editor view stays sharp
+    const bool timed = view == View::Game && DynamicResolution::GetInstance().IsEnabled();
+    const float scale = view == View::Game ? DynamicResolution::GetInstance().GetScale() : 1.0f;
+    const int renderWidth = std::max(1, (int)(width * scale + 0.5f));
+    const int renderHeight = std::max(1, (int)(height * scale + 0.5f));
+    const bool scaled = renderWidth != width || renderHeight != height;
+
+    const std::string name = view == View::Editor ? "Editor View" : "Game View";
+    FrameGraph::Resource output = frameGraph.Import(name, state.target);
+
+    // At full size the scene draws straight into the output, the backbuffer brings its own depth
+    FrameGraph::Resource color = scaled ? frameGraph.Create(name + " Scaled", RenderTargetDesc{ renderWidth, renderHeight, GL_RGBA8 }) : output;
+    FrameGraph::Resource depth = toBackbuffer && !scaled ? FrameGraph::INVALID_RESOURCE : frameGraph.Create(name + " Depth", RenderTargetDesc{ renderWidth, renderHeight, GL_DEPTH_COMPONENT24 });
+
+    std::vector<FrameGraph::Resource> writes = { color };
+    if (depth != FrameGraph::INVALID_RESOURCE) {
+        writes.push_back(depth);
     }
 
-    // Update WindowManager viewport dimensions to match scene rendering area
-    WindowManager::SetViewportDimensions(width, height);
+    frameGraph.AddPass(name, {}, writes, [color, depth, renderWidth, renderHeight, timed, draw](const FrameGraph& graph) {
+        // Update WindowManager viewport dimensions to match scene rendering area
+        WindowManager::SetViewportDimensions(renderWidth, renderHeight);
+
+        // Bind framebuffer and set viewport, 0 when drawing straight to the backbuffer
+        RenderTarget* colorTarget = graph.GetTarget(color);
+        glBindFramebuffer(GL_FRAMEBUFFER, colorTarget ? graph.GetFramebuffer(color, depth) : 0);
+        glViewport(0, 0, renderWidth, renderHeight);
+
+        // Enable depth testing for 3D rendering
+        GLStateCache::GetInstance().SetDepthTest(true);
 
-    // Bind framebuffer and set viewport
-    glBindFramebuffer(GL_FRAMEBUFFER, sceneFrameBuffer);
-    glViewport(0, 0, width, height);
+        if (timed) {
+            DynamicResolution::GetInstance().BeginGpuTimer();
+        }
+        draw();
+        if (timed) {
+            DynamicResolution::GetInstance().EndGpuTimer();
+        }
+
+        // Unbind framebuffer (render to screen again)
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    });
+
+    if (!scaled) {
+        return;
+    }
+
+    frameGraph.AddPass(name + " Upscale", { color }, { output }, [color, output, renderWidth, renderHeight, width, height](const FrameGraph& graph) {
+        RenderTarget* outputTarget = graph.GetTarget(output);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, graph.GetFramebuffer(color, FrameGraph::INVALID_RESOURCE));
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, outputTarget ? graph.GetFramebuffer(output, FrameGraph::INVALID_RESOURCE) : 0);
+        glBlitFramebuffer(0, 0, renderWidth, renderHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // Anything drawn after the view (the UI) covers the whole output again
+        WindowManager::SetViewportDimensions(width, height);
+        glViewport(0, 0, width, height);
+    });
+}
 
-    // Enable depth testing for 3D rendering
-    glEnable(GL_DEPTH_TEST);
+unsigned int SceneRenderer::GetViewTexture(View view)
+{
+    const ViewState& state = views[static_cast<int>(view)];
+    return state.target ? state.target->texture : 0;
 }
 
-void SceneRenderer::EndSceneRender()
+glm::vec2 SceneRenderer::GetViewUVScale(View view)
 {
-    // Unbind framebuffer (render to screen again)
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    const ViewState& state = views[static_cast<int>(view)];
+    if (!state.target) {
+        return glm::vec2(1.0f);
+    }
+    return glm::vec2((float)state.width / (float)state.target->width, (float)state.height / (float)state.target->height);
 }
 
 void SceneRenderer::RenderScene()
 {
     try {
-        Engine::Draw();
+        // Not through Engine::Draw, which adds this pass itself while dynamic resolution is on
+        SceneManager::GetInstance().DrawScene();
     } catch (const std::exception& e) {
         std::cerr << "Exception in SceneRenderer::RenderScene: " << e.what() << std::endl;
     }
@@ -142,8 +182,7 @@ void SceneRenderer::RenderSceneForEditor(const glm::vec3& cameraPos, const glm::
         editorCamera->Up = cameraUp;
         editorCamera->Zoom = cameraZoom;
 
-        // Get the ECS manager and graphics manager
-        ECSManager& mainECS = ECSRegistry::GetInstance().GetECSManager("TestScene");
+        // Get the graphics manager
         GraphicsManager& gfxManager = GraphicsManager::GetInstance();
 
         // Set the static editor camera (this won't be updated by input)
@@ -153,20 +192,16 @@ void SceneRenderer::RenderSceneForEditor(const glm::vec3& cameraPos, const glm::
         gfxManager.BeginFrame();
         gfxManager.Clear();
 
-        // Update model system for rendering (without input-based updates)
-        if (mainECS.modelSystem) {
-            mainECS.modelSystem->Update();
+        // Shares the scene's render world with the Game view, so only culling and sorting run again for this camera
+        SceneInstance* currentScene = static_cast<SceneInstance*>(SceneManager::GetInstance().GetCurrentScene());
+        if (currentScene) {
+            currentScene->ExtractRenderWorld();
         }
-		if (mainECS.textSystem)
-		{
-			mainECS.textSystem->Update();
-		}
 
         // Render the scene
         gfxManager.Render();
 
         // Draw light cubes using the static editor camera (not the game camera)
-        SceneInstance* currentScene = static_cast<SceneInstance*>(SceneManager::GetInstance().GetCurrentScene());
         if (currentScene) {
             currentScene->DrawLightCubes(*editorCamera);
         }
@@ -1,6 +1,10 @@
 #include "pch.h"
 
 #include "Graphics/ShaderClass.h"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/UniformBuffers.hpp"
+#include "Graphics/ClusteredLighting.hpp"
+#include "Graphics/RenderStats.hpp"
 
 std::string get_file_contents(const char* filename)
 {
@@ -26,6 +30,53 @@ bool Shader::LoadAsset(const std::string& path) {
 	std::string vertexCode = get_file_contents(vertexFile.c_str());
 	std::string fragmentCode = get_file_contents(fragmentFile.c_str());
 
+	if (!compileProgram(vertexCode, fragmentCode))
+	{
+		return false;
+	}
+
+	// The instanced variant is compiled here from the same sources rather than on first use,
+	// which would stall mid-frame (on the render thread when it runs) on file reads and compilation
+	if (m_instancedVariant)
+	{
+		m_instancedVariant->Delete();
+		m_instancedVariant.reset();
+	}
+	if (vertexCode.find("INSTANCED") != std::string::npos)
+	{
+		auto variant = std::make_unique<Shader>();
+		if (variant->compileProgram(injectDefine(vertexCode, "INSTANCED"), injectDefine(fragmentCode, "INSTANCED")))
+		{
+			m_instancedVariant = std::move(variant);
+		}
+		else
+		{
+			std::cerr << "[Shader] Failed to compile instanced variant of: " << path << std::endl;
+		}
+	}
+
+	std::cout << "Successfully loaded shader ID: " << ID << " from: " << path << std::endl;
+	return true;
+}
+
+std::string Shader::injectDefine(const std::string& source, const std::string& define)
+{
+	// Defines have to come after the #version line
+	size_t insertAt = 0;
+	size_t versionPos = source.find("#version");
+	if (versionPos != std::string::npos)
+	{
+		size_t lineEnd = source.find('\n', versionPos);
+		insertAt = (lineEnd == std::string::npos) ? source.size() : lineEnd + 1;
+	}
+
+	std::string result = source;
+	result.insert(insertAt, "#define " + define + "\n");
+	return result;
+}
+
+bool Shader::compileProgram(const std::string& vertexCode, const std::string& fragmentCode)
+{
 	// Convert the shader source strings into character arrays
 	const char* vertexSource = vertexCode.c_str();
 	const char* fragmentSource = fragmentCode.c_str();
@@ -81,145 +132,289 @@ bool Shader::LoadAsset(const std::string& path) {
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
 
-	if (success) 
-	{
-		std::cout << "Successfully loaded shader ID: " << ID << " from: " << path << std::endl;
-		return true;
-	}
+	// Hook up the shared camera/light uniform blocks and cluster light lists, if this shader uses them
+	UniformBuffers::BindShaderBlocks(ID);
+	ClusteredLighting::BindShaderSamplers(ID);
+
+	// Build the uniform lookup table once so setters never touch strings
+	resolveUniforms();
 
 	return true;
 }
 
 void Shader::Activate()
 {
-	glUseProgram(ID);
+	GLStateCache::GetInstance().UseProgram(ID);
 }
 
 void Shader::Delete()
 {
+	if (m_instancedVariant)
+	{
+		m_instancedVariant->Delete();
+		m_instancedVariant.reset();
+	}
+
 	glDeleteProgram(ID);
+	GLStateCache::GetInstance().OnProgramDeleted(ID);
 }
 
-void Shader::setBool(const std::string& name, GLboolean value)
+void Shader::setBool(UniformID id, GLboolean value)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform1i(location, (int)value);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setInt(const std::string& name, int value)
+void Shader::setInt(UniformID id, int value)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform1i(location, value);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setIntArray(const std::string& name, const GLint* values, GLint count)
+void Shader::setIntArray(UniformID id, const GLint* values, GLint count)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform1iv(location, count, values);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setFloat(const std::string& name, GLfloat value)
+void Shader::setFloat(UniformID id, GLfloat value)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform1f(location, value);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setVec2(const std::string& name, const glm::vec2& value)
+void Shader::setVec2(UniformID id, const glm::vec2& value)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform2fv(location, 1, &value[0]);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setVec2(const std::string& name, float x, float y)
+void Shader::setVec2(UniformID id, float x, float y)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform2f(location, x, y);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setVec3(const std::string& name, const glm::vec3& value)
+void Shader::setVec3(UniformID id, const glm::vec3& value)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform3fv(location, 1, &value[0]);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setVec3(const std::string& name, float x, float y, float z)
+void Shader::setVec3(UniformID id, float x, float y, float z)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform3f(location, x, y, z);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setVec4(const std::string& name, const glm::vec4& value)
+void Shader::setVec4(UniformID id, const glm::vec4& value)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform4fv(location, 1, &value[0]);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setVec4(const std::string& name, float x, float y, float z, float w)
+void Shader::setVec4(UniformID id, float x, float y, float z, float w)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniform4f(location, x, y, z, w);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setMat2(const std::string& name, const glm::mat2& mat)
+void Shader::setMat2(UniformID id, const glm::mat2& mat)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setMat3(const std::string& name, const glm::mat3& mat)
+void Shader::setMat3(UniformID id, const glm::mat3& mat)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-void Shader::setMat4(const std::string& name, const glm::mat4& mat)
+void Shader::setMat4(UniformID id, const glm::mat4& mat)
 {
-	GLint location = getUniformLocation(name);
+	GLint location = getUniformLocation(id);
 	if (location != -1) {
 		glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+		RENDER_STATS_ADD(uniformUploads, 1);
 	}
 }
 
-GLint Shader::getUniformLocation(const std::string& name)
+void Shader::setBool(const std::string& name, GLboolean value)
+{
+	setBool(UniformID(name), value);
+}
+
+void Shader::setInt(const std::string& name, int value)
+{
+	setInt(UniformID(name), value);
+}
+
+void Shader::setIntArray(const std::string& name, const GLint* values, GLint count)
+{
+	setIntArray(UniformID(name), values, count);
+}
+
+void Shader::setFloat(const std::string& name, GLfloat value)
+{
+	setFloat(UniformID(name), value);
+}
+
+void Shader::setVec2(const std::string& name, const glm::vec2& value)
+{
+	setVec2(UniformID(name), value);
+}
+
+void Shader::setVec2(const std::string& name, float x, float y)
+{
+	setVec2(UniformID(name), x, y);
+}
+
+void Shader::setVec3(const std::string& name, const glm::vec3& value)
+{
+	setVec3(UniformID(name), value);
+}
+
+void Shader::setVec3(const std::string& name, float x, float y, float z)
 {
-	auto it = m_uniformCache.find(name);
-	if (it != m_uniformCache.end())
+	setVec3(UniformID(name), x, y, z);
+}
+
+void Shader::setVec4(const std::string& name, const glm::vec4& value)
+{
+	setVec4(UniformID(name), value);
+}
+
+void Shader::setVec4(const std::string& name, float x, float y, float z, float w)
+{
+	setVec4(UniformID(name), x, y, z, w);
+}
+
+void Shader::setMat2(const std::string& name, const glm::mat2& mat)
+{
+	setMat2(UniformID(name), mat);
+}
+
+void Shader::setMat3(const std::string& name, const glm::mat3& mat)
+{
+	setMat3(UniformID(name), mat);
+}
+
+void Shader::setMat4(const std::string& name, const glm::mat4& mat)
+{
+	setMat4(UniformID(name), mat);
+}
+
+void Shader::clearUniformCache()
+{
+	resolveUniforms();
+}
+
+void Shader::resolveUniforms()
+{
+	m_uniformTable.clear();
+
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::string name(static_cast<size_t>(std::max(maxNameLength, 1)), '\0');
+	for (GLint i = 0; i < uniformCount; i++)
 	{
-		return it->second;
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, static_cast<GLuint>(i), maxNameLength, &length, &size, &type, &name[0]);
+		std::string_view uniformName(name.data(), static_cast<size_t>(length));
+
+		// Members of uniform blocks have no location and are fed through their buffer instead
+		GLint location = glGetUniformLocation(ID, name.c_str());
+		if (location == -1)
+		{
+			continue;
+		}
+
+		m_uniformTable.push_back({ UniformID::Hash(uniformName), location });
+
+		// Arrays are reported as "name[0]", register the bare name and every element as well
+		if (uniformName.size() > 3 && uniformName.substr(uniformName.size() - 3) == "[0]")
+		{
+			std::string_view baseName = uniformName.substr(0, uniformName.size() - 3);
+			m_uniformTable.push_back({ UniformID::Hash(baseName), location });
+
+			for (GLint element = 1; element < size; element++)
+			{
+				std::string elementName = std::string(baseName) + "[" + std::to_string(element) + "]";
+				GLint elementLocation = glGetUniformLocation(ID, elementName.c_str());
+				if (elementLocation != -1)
+				{
+					m_uniformTable.push_back({ UniformID::Hash(elementName), elementLocation });
+				}
+			}
+		}
 	}
 
-	GLint location = glGetUniformLocation(ID, name.c_str());
-	m_uniformCache[name] = location;
+	std::sort(m_uniformTable.begin(), m_uniformTable.end(),
+		[](const UniformSlot& a, const UniformSlot& b) { return a.hash < b.hash; });
 
-	// Debug output for missing uniforms (can be removed later)
-	if (location == -1)
+	for (size_t i = 1; i < m_uniformTable.size(); i++)
 	{
-		std::cout << "Warning: Uniform '" << name << "' not found in shader ID: " << ID << std::endl;
+		if (m_uniformTable[i].hash == m_uniformTable[i - 1].hash && m_uniformTable[i].location != m_uniformTable[i - 1].location)
+		{
+			std::cerr << "[Shader] Warning: Uniform name hash collision in shader ID: " << ID << std::endl;
+		}
 	}
-
-	return location;
 }
+
+GLint Shader::getUniformLocation(UniformID id)
+{
+	auto it = std::lower_bound(m_uniformTable.begin(), m_uniformTable.end(), id.hash,
+		[](const UniformSlot& slot, uint32_t hash) { return slot.hash < hash; });
+	if (it != m_uniformTable.end() && it->hash == id.hash)
+	{
+		return it->location;
+	}
+
+	// Debug output for missing uniforms (can be removed later). Remember the miss so it only prints once
+	std::cout << "Warning: Uniform '" << (id.name ? id.name : "<unknown>") << "' not found in shader ID: " << ID << std::endl;
+	m_uniformTable.insert(it, { id.hash, -1 });
+
+	return -1;
+}
\ No newline at end of file
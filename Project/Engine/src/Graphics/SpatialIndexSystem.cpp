@@ -0,0 +1,154 @@
+#include "pch.h"
+#include "Graphics/SpatialIndexSystem.hpp"
+#include "Graphics/GraphicsManager.hpp"
+#include "Graphics/Model/ModelRenderComponent.hpp"
+#include "Graphics/Model/Model.h"
+#include "ECS/ECSRegistry.hpp"
+#include <Transform/TransformComponent.hpp>
+
+void SpatialIndexSystem::Update()
+{
+	ECSManager& ecsManager = ECSRegistry::GetInstance().GetActiveECSManager();
+	updateStamp++;
+
+	for (const auto& entity : entities)
+	{
+		glm::mat4 transform = GraphicsManager::ConvertMatrix4x4ToGLM(ecsManager.GetComponent<Transform>(entity).model);
+
+		const Model* model = nullptr;
+		auto modelComponent = ecsManager.TryGetComponent<ModelRenderComponent>(entity);
+		if (modelComponent.has_value())
+		{
+			model = modelComponent->get().model.get();
+		}
+
+		auto it = records.find(entity);
+		if (it != records.end() && it->second.transform == transform && it->second.model == model)
+		{
+			// Nothing moved, only mark it as still alive
+			it->second.updateStamp = updateStamp;
+			continue;
+		}
+
+		AABB localBounds = model ? model->localBounds : AABB(glm::vec3(-0.5f), glm::vec3(0.5f));
+		if (!localBounds.IsValid())
+		{
+			continue;
+		}
+		AABB worldBounds = localBounds.Transformed(transform);
+
+		if (it == records.end())
+		{
+			Record record;
+			record.proxyId = tree.CreateProxy(worldBounds, entity);
+			it = records.emplace(entity, record).first;
+		}
+		else
+		{
+			tree.MoveProxy(it->second.proxyId, worldBounds);
+		}
+
+		it->second.worldBounds = worldBounds;
+		it->second.transform = transform;
+		it->second.model = model;
+		it->second.updateStamp = updateStamp;
+	}
+
+	// Anything not seen this update was destroyed or lost its components
+	for (auto it = records.begin(); it != records.end();)
+	{
+		if (it->second.updateStamp != updateStamp)
+		{
+			tree.DestroyProxy(it->second.proxyId);
+			it = records.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void SpatialIndexSystem::Shutdown()
+{
+	tree.Clear();
+	records.clear();
+}
+
+void SpatialIndexSystem::QueryFrustum(const Frustum& frustum, std::vector<Entity>& out) const
+{
+	tree.QueryFrustum(frustum, [&](int32_t proxyId) {
+		out.push_back(tree.GetUserData(proxyId));
+		return true;
+	});
+}
+
+void SpatialIndexSystem::QueryAABB(const AABB& box, std::vector<Entity>& out) const
+{
+	tree.QueryAABB(box, [&](int32_t proxyId) {
+		out.push_back(tree.GetUserData(proxyId));
+		return true;
+	});
+}
+
+void SpatialIndexSystem::QuerySphere(const BoundingSphere& sphere, std::vector<Entity>& out) const
+{
+	tree.QuerySphere(sphere, [&](int32_t proxyId) {
+		out.push_back(tree.GetUserData(proxyId));
+		return true;
+	});
+}
+
+bool SpatialIndexSystem::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, SpatialRaycastHit& hit) const
+{
+	const glm::vec3 invDirection = 1.0f / direction;
+	bool found = false;
+
+	tree.RayCast(origin, direction, maxDistance, [&](int32_t proxyId, float currentMax) {
+		Entity entity = tree.GetUserData(proxyId);
+		auto it = records.find(entity);
+		if (it == records.end())
+		{
+			return currentMax;
+		}
+
+		// The tree only tested the fattened box, check the tight one
+		const Record& record = it->second;
+		float distance;
+		if (!DynamicAABBTree::RayIntersectsAABB(origin, invDirection, record.worldBounds, currentMax, distance))
+		{
+			return currentMax;
+		}
+
+		bool hitTriangle = false;
+		TriangleRayHit triangleHit;
+		if (record.model && !record.model->triangleBVH.Empty())
+		{
+			// Transform the ray into model space. The direction is left unnormalized so the
+			// hit distance stays in world units
+			glm::mat4 inverse = glm::inverse(record.transform);
+			glm::vec3 localOrigin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+			glm::vec3 localDirection = glm::vec3(inverse * glm::vec4(direction, 0.0f));
+
+			if (!record.model->Raycast(localOrigin, localDirection, currentMax, triangleHit))
+			{
+				return currentMax;
+			}
+			distance = triangleHit.distance;
+			hitTriangle = true;
+		}
+
+		found = true;
+		hit.entity = entity;
+		hit.distance = distance;
+		hit.point = origin + direction * distance;
+		hit.hitTriangle = hitTriangle;
+		hit.meshIndex = hitTriangle ? triangleHit.meshIndex : 0;
+		hit.triangleIndex = hitTriangle ? triangleHit.triangleIndex : 0;
+
+		// Clip the ray so farther subtrees are skipped
+		return distance;
+	});
+
+	return found;
+}
@@ -0,0 +1,188 @@
+#include "pch.h"
+#include "Graphics/StaticBatcher.hpp"
+#include "Graphics/GraphicsManager.hpp"
+#include "Graphics/Model/ModelRenderComponent.hpp"
+#include "ECS/ECSManager.hpp"
+#include <Transform/TransformComponent.hpp>
+
+namespace {
+	struct BatchKey {
+		glm::ivec3 chunk;
+		const Material* material;
+		const Shader* shader;
+		int renderOrder;
+
+		bool operator==(const BatchKey& other) const
+		{
+			return chunk == other.chunk && material == other.material && shader == other.shader && renderOrder == other.renderOrder;
+		}
+	};
+
+	struct BatchKeyHash {
+		size_t operator()(const BatchKey& key) const
+		{
+			size_t hash = std::hash<const void*>()(key.material);
+			hash ^= std::hash<const void*>()(key.shader) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			hash ^= std::hash<int>()(key.chunk.x * 73856093 ^ key.chunk.y * 19349663 ^ key.chunk.z * 83492791) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			hash ^= std::hash<int>()(key.renderOrder) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			return hash;
+		}
+	};
+
+	struct PendingBatch {
+		std::vector<Vertex> vertices;
+		std::vector<GLuint> indices;
+		std::shared_ptr<Material> material;
+		std::shared_ptr<Shader> shader;
+		int renderOrder = 0;
+	};
+
+	bool CanBatch(const Mesh& mesh)
+	{
+		return mesh.material && mesh.material->getOpacity() >= 1.0f && !mesh.indices.empty();
+	}
+
+	// Static entities with any mesh that can't be merged stay on the regular path as a whole
+	bool CanBatch(const ModelRenderComponent& modelComponent)
+	{
+		if (!modelComponent.isStatic || !modelComponent.isVisible || !modelComponent.model || !modelComponent.shader)
+		{
+			return false;
+		}
+
+		for (const Mesh& mesh : modelComponent.model->meshes)
+		{
+			if (!CanBatch(mesh))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+void StaticBatcher::Build(ECSManager& ecsManager, const std::set<Entity>& entities)
+{
+	Clear();
+
+	std::unordered_map<BatchKey, PendingBatch, BatchKeyHash> pending;
+	size_t sourceMeshCount = 0;
+
+	for (const auto& entity : entities)
+	{
+		auto& modelComponent = ecsManager.GetComponent<ModelRenderComponent>(entity);
+		if (!CanBatch(modelComponent))
+		{
+			continue;
+		}
+
+		glm::mat4 transform = GraphicsManager::ConvertMatrix4x4ToGLM(ecsManager.GetComponent<Transform>(entity).model);
+		glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+		for (const Mesh& mesh : modelComponent.model->meshes)
+		{
+			// Chunk by the mesh's world space center so a mesh never straddles two batches
+			glm::vec3 center = glm::vec3(transform * glm::vec4(mesh.localBounds.Center(), 1.0f));
+			BatchKey key{ glm::ivec3(glm::floor(center / CHUNK_SIZE)), mesh.material.get(), modelComponent.shader.get(), modelComponent.renderOrder };
+
+			PendingBatch& batch = pending[key];
+			if (!batch.material)
+			{
+				batch.material = mesh.material;
+				batch.shader = modelComponent.shader;
+				batch.renderOrder = modelComponent.renderOrder;
+			}
+
+			GLuint baseVertex = static_cast<GLuint>(batch.vertices.size());
+			for (const Vertex& vertex : mesh.vertices)
+			{
+				Vertex worldVertex = vertex;
+				worldVertex.position = glm::vec3(transform * glm::vec4(vertex.position, 1.0f));
+				worldVertex.normal = glm::normalize(normalMatrix * vertex.normal);
+				batch.vertices.push_back(worldVertex);
+			}
+			for (GLuint index : mesh.indices)
+			{
+				batch.indices.push_back(baseVertex + index);
+			}
+			sourceMeshCount++;
+		}
+
+		batchedEntities.emplace(entity, transform);
+	}
+
+	batches.reserve(pending.size());
+	for (auto& [key, pendingBatch] : pending)
+	{
+		Batch batch;
+		batch.mesh = std::make_unique<Mesh>(pendingBatch.vertices, pendingBatch.indices, pendingBatch.material);
+		batch.shader = pendingBatch.shader;
+		batch.renderOrder = pendingBatch.renderOrder;
+		batches.push_back(std::move(batch));
+	}
+
+	if (!batchedEntities.empty())
+	{
+		std::cout << "[StaticBatcher] Merged " << sourceMeshCount << " meshes from " << batchedEntities.size()
+			<< " static entities into " << batches.size() << " batches" << std::endl;
+	}
+}
+
+void StaticBatcher::Clear()
+{
+	batches.clear();
+	batchedEntities.clear();
+}
+
+bool StaticBatcher::NeedsRebuild(ECSManager& ecsManager, const std::set<Entity>& entities) const
+{
+	for (const auto& entity : entities)
+	{
+		auto& modelComponent = ecsManager.GetComponent<ModelRenderComponent>(entity);
+		bool batchable = CanBatch(modelComponent);
+
+		auto it = batchedEntities.find(entity);
+		if (it == batchedEntities.end())
+		{
+			// Newly flagged static
+			if (batchable)
+			{
+				return true;
+			}
+			continue;
+		}
+
+		// Un-flagged, hidden or moved since it was baked
+		if (!batchable || GraphicsManager::ConvertMatrix4x4ToGLM(ecsManager.GetComponent<Transform>(entity).model) != it->second)
+		{
+			return true;
+		}
+	}
+
+	// Destroyed entities or ones that lost their model component
+	for (const auto& [entity, transform] : batchedEntities)
+	{
+		if (entities.find(entity) == entities.end())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+size_t StaticBatcher::Submit(GraphicsManager& gfxManager, const Frustum& frustum) const
+{
+	size_t submitted = 0;
+	for (const Batch& batch : batches)
+	{
+		// Batch vertices are already in world space, so the local bounds are world bounds
+		if (!frustum.IntersectsAABB(batch.mesh->localBounds))
+		{
+			continue;
+		}
+
+		gfxManager.SubmitStaticMesh(batch.mesh.get(), batch.shader.get(), batch.renderOrder);
+		submitted++;
+	}
+	return submitted;
+}
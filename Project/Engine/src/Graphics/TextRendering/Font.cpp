@@ -1,9 +1,10 @@
 #include "pch.h"
 #include "Graphics/TextRendering/Font.hpp"
-#include "Graphics/VAO.h"
-#include "Graphics/VBO.h"
+#include "Graphics/TextRendering/TextUtils.hpp"
+#include <cstring>
+#include FT_MODULE_H
 
-Font::Font(unsigned int defaultFontSize) : fontSize(defaultFontSize) {}
+Font::Font(unsigned int defaultFontSize, GlyphMode mode) : fontSize(defaultFontSize), glyphMode(mode) {}
 
 Font::~Font()
 {
@@ -24,90 +25,46 @@ bool Font::LoadFont(const std::string& path, unsigned int fontSizeParam)
     // Clean up existing font data if any
     Cleanup();
 
-    // Initialize FreeType
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft)) 
+    // Initialize FreeType. The library and face stay open, glyphs are rasterized as text first uses them
+    if (FT_Init_FreeType(&library)) 
     {
         std::cerr << "[Font] Could not initialize FreeType Library" << std::endl;
+        library = nullptr;
         return false;
     }
 
     // Load font as face
-    FT_Face face;
-    if (FT_New_Face(ft, path.c_str(), 0, &face)) 
+    if (FT_New_Face(library, path.c_str(), 0, &face)) 
     {
         std::cerr << "[Font] Failed to load font: " << path << std::endl;
-        FT_Done_FreeType(ft);
+        face = nullptr;
+        Cleanup();
         return false;
     }
 
+    // Distance fields need outlines, bitmap-only fonts fall back to plain glyphs
+    if (glyphMode == GlyphMode::SDF && !FT_IS_SCALABLE(face))
+    {
+        std::cerr << "[Font] Font has no outlines, using bitmap glyphs: " << path << std::endl;
+        glyphMode = GlyphMode::BITMAP;
+    }
+    if (glyphMode == GlyphMode::SDF)
+    {
+        FT_Int spread = SDF_SPREAD;
+        FT_Property_Set(library, "sdf", "spread", &spread);
+    }
+
     // Sets the font's width and height parameters
     // Setting the width to 0 lets the face dynamically calculate the width based on the given height
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
-
-    // Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    // Load first 128 characters of ASCII set
-    for (unsigned char c = 0; c < 128; c++) 
-    {
-        // Load character glyph
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) 
-        {
-            std::cerr << "[Font] Failed to load Glyph for character: " << c << std::endl;
-            continue;
-        }
+    const unsigned int pixelSize = glyphMode == GlyphMode::SDF ? SDF_BASE_SIZE : fontSize;
+    FT_Set_Pixel_Sizes(face, 0, pixelSize);
+    glyphScale = static_cast<float>(fontSize) / pixelSize;
+    lineHeight = static_cast<float>(face->size->metrics.height >> 6);
+    maxGlyphHeight = static_cast<float>((face->size->metrics.ascender - face->size->metrics.descender) >> 6);
 
-        // Generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // Store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            static_cast<unsigned int>(face->glyph->advance.x)
-        };
-        Characters.insert(std::pair<char, Character>(c, character));
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    // Destroy FreeType once we're finished
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-
-    // Set up VAO/VBO for text rendering using your extended classes
-    textVAO = std::make_unique<VAO>();
-    textVBO = std::make_unique<VBO>(sizeof(float) * 6 * 4, GL_DYNAMIC_DRAW);
-
-    textVAO->Bind();
-    textVBO->Bind();
-
-    // Set up vertex attributes for text (vec4: x, y, u, v)
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-
-    textVBO->Unbind();
-    textVAO->Unbind();
+    atlas.Reset(ATLAS_PAGE_SIZE, ATLAS_PAGES);
+    RebuildGlyphTable(256, GlyphAtlas::NO_PAGE);
+    generation++;
 
     std::cout << "[Font] Successfully loaded font: " << path << " (size: " << fontSize << ")" << std::endl;
     return true;
@@ -115,70 +72,228 @@ bool Font::LoadFont(const std::string& path, unsigned int fontSizeParam)
 
 void Font::SetFontSize(unsigned int newSize)
 {
-    if (newSize != fontSize && !fontPath.empty()) 
+    if (newSize == fontSize)
+    {
+        return;
+    }
+
+    // Distance fields scale cleanly, only the metrics change
+    if (glyphMode == GlyphMode::SDF && face)
+    {
+        fontSize = newSize;
+        glyphScale = static_cast<float>(fontSize) / SDF_BASE_SIZE;
+        generation++;
+    }
+    else if (!fontPath.empty()) 
     {
         LoadFont(fontPath, newSize);
     }
 }
 
-const Character& Font::GetCharacter(char c) const
+void Font::SetGlyphMode(GlyphMode newMode)
+{
+    if (newMode != glyphMode)
+    {
+        glyphMode = newMode;
+        if (!fontPath.empty())
+        {
+            LoadFont(fontPath, fontSize);
+        }
+    }
+}
+
+Character Font::GetCharacter(uint32_t codepoint)
 {
-    auto it = Characters.find(c);
-    if (it != Characters.end()) 
+    if (GlyphSlot* slot = FindGlyph(codepoint))
     {
-        return it->second;
+        if (slot->character.page != GlyphAtlas::NO_PAGE)
+        {
+            atlas.Touch(slot->character.page);
+        }
+        return slot->character;
     }
 
-    // Return space character as fallback
-    static Character fallback = {};
-    return fallback;
+    return LoadGlyph(codepoint);
+}
+
+void Font::TouchPages(uint32_t pageMask)
+{
+    for (uint32_t page = 0; page < atlas.GetPageCount() && pageMask != 0; page++, pageMask >>= 1)
+    {
+        if (pageMask & 1u)
+        {
+            atlas.Touch(page);
+        }
+    }
 }
 
-float Font::GetTextWidth(const std::string& text, float scale) const
+float Font::GetTextWidth(const std::string& text, float scale)
 {
+    // Widest line for multi-line text
     float width = 0.0f;
-    for (char c : text) 
+    float lineWidth = 0.0f;
+    for (size_t i = 0; i < text.size();) 
     {
-        const Character& ch = GetCharacter(c);
-        width += (ch.advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64)
+        uint32_t codepoint = TextUtils::DecodeUTF8(text, i);
+        if (codepoint == '\n')
+        {
+            width = std::max(width, lineWidth);
+            lineWidth = 0.0f;
+            continue;
+        }
+
+        lineWidth += (GetCharacter(codepoint).advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64)
     }
-    return width;
+    return std::max(width, lineWidth) * glyphScale;
 }
 
-float Font::GetTextHeight(float scale) const
+Font::GlyphSlot* Font::FindGlyph(uint32_t codepoint)
 {
-    float maxHeight = 0.0f;
-    for (const auto& pair : Characters) 
+    if (glyphTable.empty())
+    {
+        return nullptr;
+    }
+
+    const size_t mask = glyphTable.size() - 1;
+    uint32_t hash = codepoint * 0x9E3779B1u;
+    for (size_t index = (hash ^ (hash >> 16)) & mask; ; index = (index + 1) & mask)
     {
-        float height = pair.second.size.y * scale;
-        if (height > maxHeight) 
+        if (glyphTable[index].codepoint == codepoint)
         {
-            maxHeight = height;
+            return &glyphTable[index];
+        }
+        if (glyphTable[index].codepoint == EMPTY_SLOT)
+        {
+            return nullptr;
         }
     }
-    return maxHeight;
 }
 
-void Font::Cleanup()
+void Font::InsertGlyph(uint32_t codepoint, const Character& character)
 {
-    // Clean up textures
-    for (auto& pair : Characters) 
+    // Keep the table under 70% full so probes stay short
+    if ((glyphCount + 1) * 10 > glyphTable.size() * 7)
     {
-        glDeleteTextures(1, &pair.second.textureID);
+        RebuildGlyphTable(std::max<size_t>(glyphTable.size() * 2, 256), GlyphAtlas::NO_PAGE);
     }
-    Characters.clear();
 
-    // Clean up VAO/VBO
-    if (textVAO) 
+    const size_t mask = glyphTable.size() - 1;
+    uint32_t hash = codepoint * 0x9E3779B1u;
+    size_t index = (hash ^ (hash >> 16)) & mask;
+    while (glyphTable[index].codepoint != EMPTY_SLOT)
     {
-        textVAO->Delete();
-        textVAO.reset();
+        index = (index + 1) & mask;
     }
-    if (textVBO) 
+
+    glyphTable[index].codepoint = codepoint;
+    glyphTable[index].character = character;
+    glyphCount++;
+}
+
+void Font::RebuildGlyphTable(size_t capacity, uint32_t droppedPage)
+{
+    // Glyphs on an evicted page are dropped rather than tombstoned, eviction is rare
+    std::vector<GlyphSlot> previous = std::move(glyphTable);
+    glyphTable.assign(capacity, GlyphSlot{});
+    glyphCount = 0;
+
+    for (const GlyphSlot& slot : previous)
     {
-        textVBO->Delete();
-        textVBO.reset();
+        if (slot.codepoint != EMPTY_SLOT && (droppedPage == GlyphAtlas::NO_PAGE || slot.character.page != droppedPage))
+        {
+            InsertGlyph(slot.codepoint, slot.character);
+        }
     }
 }
 
+Character Font::LoadGlyph(uint32_t codepoint)
+{
+    Character character{};
+    if (!face)
+    {
+        return character;
+    }
 
+    // Missing codepoints load the font's .notdef glyph
+    if (FT_Load_Char(face, codepoint, glyphMode == GlyphMode::SDF ? FT_LOAD_DEFAULT : FT_LOAD_RENDER)) 
+    {
+        std::cerr << "[Font] Failed to load Glyph for codepoint: U+" << std::hex << codepoint << std::dec << std::endl;
+        InsertGlyph(codepoint, character);
+        return character;
+    }
+
+    // Glyphs without an outline (whitespace) have nothing to render, they only keep their advance
+    bool hasBitmap = true;
+    if (glyphMode == GlyphMode::SDF)
+    {
+        hasBitmap = face->glyph->outline.n_points > 0;
+        if (hasBitmap && FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF))
+        {
+            std::cerr << "[Font] Failed to render distance field for codepoint: U+" << std::hex << codepoint << std::dec << std::endl;
+            hasBitmap = false;
+        }
+    }
+
+    const FT_Bitmap& bitmap = face->glyph->bitmap;
+    character.bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+    character.advance = static_cast<unsigned int>(face->glyph->advance.x);
+
+    if (hasBitmap && bitmap.width > 0 && bitmap.rows > 0)
+    {
+        glm::ivec2 position;
+        uint32_t page, evictedPage;
+        if (!atlas.Pack(bitmap.width, bitmap.rows, position, page, evictedPage))
+        {
+            // Every page is in use this frame. Skip the glyph and retry next frame
+            if (!reportedFullAtlas)
+            {
+                std::cerr << "[Font] Glyph atlas is full this frame, some glyphs are skipped: " << fontPath << std::endl;
+                reportedFullAtlas = true;
+            }
+            generation++;
+            return character;
+        }
+
+        if (evictedPage != GlyphAtlas::NO_PAGE)
+        {
+            RebuildGlyphTable(glyphTable.size(), evictedPage);
+            generation++;
+        }
+
+        // Rows can be padded by FreeType, keep them tightly packed for the atlas upload
+        glyphPixels.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+        for (unsigned int row = 0; row < bitmap.rows; row++)
+        {
+            std::memcpy(glyphPixels.data() + row * bitmap.width, bitmap.buffer + row * bitmap.pitch, bitmap.width);
+        }
+
+        character.size = glm::ivec2(bitmap.width, bitmap.rows);
+        character.page = page;
+        character.uvMin = atlas.ToUV(position);
+        character.uvMax = atlas.ToUV(position + character.size);
+        atlas.Upload(position, page, character.size.x, character.size.y, glyphPixels.data());
+    }
+
+    InsertGlyph(codepoint, character);
+    return character;
+}
+
+void Font::Cleanup()
+{
+    glyphTable.clear();
+    glyphCount = 0;
+    maxGlyphHeight = 0.0f;
+    reportedFullAtlas = false;
+    atlas.Destroy();
+
+    if (face)
+    {
+        FT_Done_Face(face);
+        face = nullptr;
+    }
+    if (library)
+    {
+        FT_Done_FreeType(library);
+        library = nullptr;
+    }
+}
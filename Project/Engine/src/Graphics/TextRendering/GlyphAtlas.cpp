@@ -0,0 +1,170 @@
+#include "pch.h"
+#include "Graphics/TextRendering/GlyphAtlas.hpp"
+#include "Graphics/GLStateCache.hpp"
+
+GlyphAtlas::~GlyphAtlas()
+{
+	Destroy();
+}
+
+void GlyphAtlas::Reset(int newPageSize, uint32_t pageCount)
+{
+	Destroy();
+
+	pageSize = newPageSize;
+	pages.assign(pageCount, Page{});
+	openPages = 0;
+}
+
+bool GlyphAtlas::Pack(int width, int height, glm::ivec2& position, uint32_t& page, uint32_t& evictedPage)
+{
+	const int paddedWidth = width + PADDING * 2;
+	const int paddedHeight = height + PADDING * 2;
+	evictedPage = NO_PAGE;
+
+	if (paddedWidth > pageSize || paddedHeight > pageSize)
+	{
+		return false;
+	}
+
+	// Shortest shelf the glyph fits on, so small glyphs don't waste tall shelves
+	Shelf* best = nullptr;
+	uint32_t bestPage = NO_PAGE;
+	for (uint32_t p = 0; p < openPages; p++)
+	{
+		for (Shelf& shelf : pages[p].shelves)
+		{
+			if (shelf.height >= paddedHeight && shelf.nextX + paddedWidth <= pageSize && (!best || shelf.height < best->height))
+			{
+				best = &shelf;
+				bestPage = p;
+			}
+		}
+	}
+
+	if (best)
+	{
+		position = glm::ivec2(best->nextX + PADDING, best->y + PADDING);
+		best->nextX += paddedWidth;
+		page = bestPage;
+		Touch(page);
+		return true;
+	}
+
+	// Then a new shelf on a page that's already in use, then a fresh page
+	for (uint32_t p = 0; p < openPages; p++)
+	{
+		if (PackOnPage(pages[p], paddedWidth, paddedHeight, position))
+		{
+			page = p;
+			Touch(page);
+			return true;
+		}
+	}
+	if (openPages < pages.size())
+	{
+		page = openPages++;
+		PackOnPage(pages[page], paddedWidth, paddedHeight, position);
+		Touch(page);
+		return true;
+	}
+
+	// Every page is full, recycle the one that has gone unused the longest
+	uint32_t oldest = NO_PAGE;
+	for (uint32_t p = 0; p < pages.size(); p++)
+	{
+		if (pages[p].lastUsedFrame < currentFrame && (oldest == NO_PAGE || pages[p].lastUsedFrame < pages[oldest].lastUsedFrame))
+		{
+			oldest = p;
+		}
+	}
+	if (oldest == NO_PAGE)
+	{
+		return false;
+	}
+
+	pages[oldest].shelves.clear();
+	pages[oldest].nextShelfY = 0;
+	ClearPage(oldest);
+
+	evictedPage = oldest;
+	page = oldest;
+	PackOnPage(pages[page], paddedWidth, paddedHeight, position);
+	Touch(page);
+	return true;
+}
+
+bool GlyphAtlas::PackOnPage(Page& page, int paddedWidth, int paddedHeight, glm::ivec2& position)
+{
+	if (page.nextShelfY + paddedHeight > pageSize)
+	{
+		return false;
+	}
+
+	page.shelves.push_back(Shelf{ page.nextShelfY, paddedHeight, paddedWidth });
+	page.nextShelfY += paddedHeight;
+	position = glm::ivec2(PADDING, page.shelves.back().y + PADDING);
+	return true;
+}
+
+void GlyphAtlas::Upload(const glm::ivec2& position, uint32_t page, int width, int height, const unsigned char* pixels)
+{
+	if (texture == 0)
+	{
+		CreateTexture();
+	}
+	if (width <= 0 || height <= 0 || !pixels)
+	{
+		return;
+	}
+
+	GLStateCache::GetInstance().BindTexture(0, texture, GL_TEXTURE_2D_ARRAY);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, position.x, position.y, page, width, height, 1, GL_RED, GL_UNSIGNED_BYTE, pixels);
+}
+
+void GlyphAtlas::Destroy()
+{
+	if (texture != 0)
+	{
+		glDeleteTextures(1, &texture);
+		GLStateCache::GetInstance().OnTextureDeleted(texture);
+		texture = 0;
+	}
+}
+
+void GlyphAtlas::CreateTexture()
+{
+	// Start cleared so the padding around glyphs is empty
+	std::vector<unsigned char> clear(static_cast<size_t>(pageSize) * pageSize * pages.size(), 0);
+
+	glGenTextures(1, &texture);
+	GLStateCache::GetInstance().BindTexture(0, texture, GL_TEXTURE_2D_ARRAY);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, pageSize, pageSize, static_cast<GLsizei>(pages.size()), 0, GL_RED, GL_UNSIGNED_BYTE, clear.data());
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void GlyphAtlas::ClearPage(uint32_t page)
+{
+	// Old glyphs would bleed into the padding of new ones
+	if (texture == 0)
+	{
+		return;
+	}
+
+	// Pages can be evicted every frame while glyphs churn, so the zeroed source is kept around
+	const size_t pageTexels = static_cast<size_t>(pageSize) * pageSize;
+	if (clearPixels.size() != pageTexels)
+	{
+		clearPixels.assign(pageTexels, 0);
+	}
+
+	GLStateCache::GetInstance().BindTexture(0, texture, GL_TEXTURE_2D_ARRAY);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, page, pageSize, pageSize, 1, GL_RED, GL_UNSIGNED_BYTE, clearPixels.data());
+}
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "Graphics/TextRendering/TextBatcher.hpp"
+#include "Graphics/TextRendering/TextRenderComponent.hpp"
+#include "Graphics/TextRendering/TextUtils.hpp"
+#include "Graphics/GLStateCache.hpp"
+#include "Graphics/RenderStats.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+uint32_t TextBatcher::Append(const TextRenderComponent& item)
+{
+	if (!item.isVisible || !item.font || item.text.empty())
+	{
+		return 0;
+	}
+
+	// 3D text is placed by its transform, 2D text by its screen position. The 2D model matrix
+	// scales on top of the scale already in the layout, as the old per-glyph renderer did
+	glm::mat4 model = item.transform;
+	if (!item.is3D)
+	{
+		model = glm::translate(glm::mat4(1.0f), item.position);
+		model = glm::scale(model, glm::vec3(item.scale, item.scale, 1.0f));
+	}
+
+	const glm::vec3 color = glm::clamp(item.color, 0.0f, 1.0f) * 255.0f;
+	const uint8_t packedColor[4] = {
+		static_cast<uint8_t>(color.r + 0.5f),
+		static_cast<uint8_t>(color.g + 0.5f),
+		static_cast<uint8_t>(color.b + 0.5f),
+		255
+	};
+
+	// Cached layouts don't look their glyphs up again, so keep their pages from being evicted this frame
+	const TextLayout& layout = TextUtils::GetLayout(item);
+	item.font->TouchPages(layout.pageMask);
+	const size_t start = vertices.size();
+
+	for (const TextLayout::Quad& glyph : layout.quads)
+	{
+		const glm::vec3 topLeft = glm::vec3(model * glm::vec4(glyph.min.x, glyph.max.y, 0.0f, 1.0f));
+		const glm::vec3 bottomLeft = glm::vec3(model * glm::vec4(glyph.min.x, glyph.min.y, 0.0f, 1.0f));
+		const glm::vec3 bottomRight = glm::vec3(model * glm::vec4(glyph.max.x, glyph.min.y, 0.0f, 1.0f));
+		const glm::vec3 topRight = glm::vec3(model * glm::vec4(glyph.max.x, glyph.max.y, 0.0f, 1.0f));
+
+		const glm::vec3 positions[6] = { topLeft, bottomLeft, bottomRight, topLeft, bottomRight, topRight };
+		const glm::vec3 uvs[6] = {
+			{ glyph.uvMin.x, glyph.uvMin.y, glyph.page }, { glyph.uvMin.x, glyph.uvMax.y, glyph.page }, { glyph.uvMax.x, glyph.uvMax.y, glyph.page },
+			{ glyph.uvMin.x, glyph.uvMin.y, glyph.page }, { glyph.uvMax.x, glyph.uvMax.y, glyph.page }, { glyph.uvMax.x, glyph.uvMin.y, glyph.page }
+		};
+		for (int corner = 0; corner < 6; corner++)
+		{
+			vertices.push_back(TextVertex{ positions[corner], uvs[corner], { packedColor[0], packedColor[1], packedColor[2], packedColor[3] } });
+		}
+	}
+
+	return static_cast<uint32_t>(vertices.size() - start);
+}
+
+void TextBatcher::Upload()
+{
+	if (vertices.empty())
+	{
+		return;
+	}
+
+	size_t requiredSize = vertices.size() * sizeof(TextVertex);
+	if (!textVBO)
+	{
+		capacity = requiredSize;
+		textVBO = std::make_unique<VBO>(capacity, GL_STREAM_DRAW);
+
+		textVAO.Bind();
+		textVBO->Bind();
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, position));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, texUV));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), (void*)offsetof(TextVertex, color));
+		textVAO.Unbind();
+	}
+	else
+	{
+		// Grow geometrically, and orphan the old storage so we don't wait on last frame's draws
+		if (requiredSize > capacity)
+		{
+			capacity = std::max(requiredSize, capacity * 2);
+		}
+		textVBO->InitializeBuffer(capacity, GL_STREAM_DRAW);
+	}
+
+	textVBO->UpdateData(vertices.data(), requiredSize);
+	textVBO->Unbind();
+}
+
+void TextBatcher::Draw(uint32_t firstVertex, uint32_t vertexCount)
+{
+	if (vertexCount == 0 || !textVBO)
+	{
+		return;
+	}
+
+	textVAO.Bind();
+	glDrawArrays(GL_TRIANGLES, static_cast<GLint>(firstVertex), static_cast<GLsizei>(vertexCount));
+	textVAO.Unbind();
+	RENDER_STATS_ADD(drawCalls, 1);
+	RENDER_STATS_ADD(triangles, vertexCount / 3);
+	RENDER_STATS_ADD(glyphs, vertexCount / 6);
+}
+
+void TextBatcher::Shutdown()
+{
+	vertices.clear();
+	textVAO.Delete();
+	textVAO.ID = 0;
+	if (textVBO)
+	{
+		textVBO->Delete();
+		textVBO.reset();
+	}
+	capacity = 0;
+}
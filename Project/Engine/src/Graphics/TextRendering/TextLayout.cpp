@@ -0,0 +1,97 @@
+#include "pch.h"
+#include "Graphics/TextRendering/TextLayout.hpp"
+#include "Graphics/TextRendering/TextRenderComponent.hpp"
+#include "Graphics/TextRendering/TextUtils.hpp"
+#include "Graphics/TextRendering/Font.hpp"
+
+bool TextLayout::IsCurrent(const TextRenderComponent& comp) const
+{
+	return version == comp.layoutVersion
+		&& font == comp.font.get()
+		&& (!font || fontGeneration == font->GetGeneration());
+}
+
+void TextLayout::Build(const TextRenderComponent& comp)
+{
+	quads.clear();
+	width = 0.0f;
+	height = 0.0f;
+	lineCount = 0;
+	pageMask = 0;
+
+	// Taken before any glyphs load. If loading evicts pages or skips glyphs the generation moves
+	// on, and the layout is rebuilt next frame
+	version = comp.layoutVersion;
+	font = comp.font.get();
+	fontGeneration = font ? font->GetGeneration() : 0;
+
+	if (!font || comp.text.empty())
+	{
+		return;
+	}
+
+	Font& glyphSource = *comp.font;
+
+	// Glyph metrics are in rasterized pixels, which differ from the font size for distance fields
+	const float scale = comp.scale * glyphSource.GetGlyphScale();
+	const float lineHeight = glyphSource.GetLineHeight(comp.scale);
+	quads.reserve(comp.text.size());
+
+	// Shifts the finished line by its alignment offset
+	auto finishLine = [&](size_t firstQuad, float lineWidth) {
+		width = std::max(width, lineWidth);
+
+		float offset = 0.0f;
+		if (comp.alignment == TextRenderComponent::Alignment::CENTER)
+		{
+			offset = -lineWidth / 2.0f;
+		}
+		else if (comp.alignment == TextRenderComponent::Alignment::RIGHT)
+		{
+			offset = -lineWidth;
+		}
+
+		for (size_t q = firstQuad; q < quads.size(); q++)
+		{
+			quads[q].min.x += offset;
+			quads[q].max.x += offset;
+		}
+		lineCount++;
+	};
+
+	float x = 0.0f;
+	size_t lineFirstQuad = 0;
+	for (size_t i = 0; i < comp.text.size();)
+	{
+		const uint32_t codepoint = TextUtils::DecodeUTF8(comp.text, i);
+		if (codepoint == '\n')
+		{
+			finishLine(lineFirstQuad, x);
+			lineFirstQuad = quads.size();
+			x = 0.0f;
+			continue;
+		}
+
+		const Character ch = glyphSource.GetCharacter(codepoint);
+		const float y = -static_cast<float>(lineCount) * lineHeight;
+
+		// Whitespace has no bitmap, only an advance
+		if (ch.page != GlyphAtlas::NO_PAGE)
+		{
+			Quad quad;
+			quad.min = glm::vec2(x + ch.bearing.x * scale, y - (ch.size.y - ch.bearing.y) * scale);
+			quad.max = quad.min + glm::vec2(ch.size) * scale;
+			quad.uvMin = ch.uvMin;
+			quad.uvMax = ch.uvMax;
+			quad.page = static_cast<float>(ch.page);
+			quads.push_back(quad);
+			pageMask |= 1u << ch.page;
+		}
+
+		// Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
+		x += (ch.advance >> 6) * scale;
+	}
+	finishLine(lineFirstQuad, x);
+
+	height = glyphSource.GetTextHeight(comp.scale) + (lineCount - 1) * lineHeight;
+}
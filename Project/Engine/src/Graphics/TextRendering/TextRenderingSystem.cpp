@@ -2,7 +2,6 @@
 #include "Graphics/TextRendering/TextRenderingSystem.hpp"
 #include "Graphics/TextRendering/TextRenderComponent.hpp"
 #include "ECS/ECSRegistry.hpp"
-#include "Graphics/GraphicsManager.hpp"
 #include "Graphics/TextRendering/TextUtils.hpp"
 
 bool TextRenderingSystem::Initialise()
@@ -11,23 +10,20 @@ bool TextRenderingSystem::Initialise()
 	return true;
 }
 
-void TextRenderingSystem::Update()
+void TextRenderingSystem::Extract(RenderWorld& world)
 {
     ECSManager& ecsManager = ECSRegistry::GetInstance().GetActiveECSManager();
-    GraphicsManager& gfxManager = GraphicsManager::GetInstance();
 
-    // Submit all visible text components to the graphics manager
+    // Gather all visible text components
     for (const auto& entity : entities) 
     {
         auto& textComponent = ecsManager.GetComponent<TextRenderComponent>(entity);
 
-        // Only submit valid, visible text
+        // Only submit valid, visible text. Components are drawn in place, their cached layout
+        // is only rebuilt when the text changes
         if (textComponent.isVisible && TextUtils::IsValid(textComponent)) 
         {
-            // Create a copy of the text component for submission
-            // This ensures the graphics manager has its own copy to work with
-            auto textRenderItem = std::make_unique<TextRenderComponent>(textComponent);
-            gfxManager.Submit(std::move(textRenderItem));
+            world.texts.push_back(&textComponent);
         }
     }
 }
@@ -4,7 +4,12 @@
 
 void TextUtils::SetText(TextRenderComponent& comp, const std::string& newText) 
 {
-    comp.text = newText;
+    // Scripts often set the same string every frame, that shouldn't cost a relayout
+    if (comp.text != newText)
+    {
+        comp.text = newText;
+        comp.layoutVersion++;
+    }
 }
 
 void TextUtils::SetColor(TextRenderComponent& comp, const glm::vec3& newColor) 
@@ -31,12 +36,20 @@ void TextUtils::SetPosition(TextRenderComponent& comp, float x, float y, float z
 
 void TextUtils::SetScale(TextRenderComponent& comp, float newScale) 
 {
-    comp.scale = newScale;
+    if (comp.scale != newScale)
+    {
+        comp.scale = newScale;
+        comp.layoutVersion++;
+    }
 }
 
 void TextUtils::SetAlignment(TextRenderComponent& comp, TextRenderComponent::Alignment newAlignment)
 {
-    comp.alignment = newAlignment;
+    if (comp.alignment != newAlignment)
+    {
+        comp.alignment = newAlignment;
+        comp.layoutVersion++;
+    }
 }
 
 void TextUtils::SetWorldTransform(TextRenderComponent& comp, const glm::mat4& newTransform)
@@ -56,21 +69,75 @@ void TextUtils::SetWorldPosition(TextRenderComponent& comp, float x, float y, fl
     SetWorldPosition(comp, glm::vec3(x, y, z));
 }
 
-float TextUtils::GetEstimatedWidth(const TextRenderComponent& comp) 
+const TextLayout& TextUtils::GetLayout(const TextRenderComponent& comp)
 {
-    if (comp.font) 
+    if (!comp.layout.IsCurrent(comp))
     {
-        return comp.font->GetTextWidth(comp.text, comp.scale);
+        comp.layout.Build(comp);
     }
-    return 0.0f;
+    return comp.layout;
+}
+
+float TextUtils::GetEstimatedWidth(const TextRenderComponent& comp) 
+{
+    return GetLayout(comp).width;
 }
 
 float TextUtils::GetEstimatedHeight(const TextRenderComponent& comp)
 {
-    if (comp.font) {
-        return comp.font->GetTextHeight(comp.scale);
+    return GetLayout(comp).height;
+}
+
+uint32_t TextUtils::DecodeUTF8(const std::string& text, size_t& index)
+{
+    constexpr uint32_t REPLACEMENT = 0xFFFD;
+    const unsigned char lead = static_cast<unsigned char>(text[index++]);
+    if (lead < 0x80)
+    {
+        return lead;
+    }
+
+    // Sequence length and minimum value from the lead byte, the minimum rejects overlong encodings
+    size_t length;
+    uint32_t codepoint;
+    uint32_t minimum;
+    if ((lead & 0xE0) == 0xC0)
+    {
+        length = 1; codepoint = lead & 0x1F; minimum = 0x80;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        length = 2; codepoint = lead & 0x0F; minimum = 0x800;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        length = 3; codepoint = lead & 0x07; minimum = 0x10000;
+    }
+    else
+    {
+        return REPLACEMENT;
+    }
+
+    if (index + length > text.size())
+    {
+        return REPLACEMENT;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        const unsigned char next = static_cast<unsigned char>(text[index + i]);
+        if ((next & 0xC0) != 0x80)
+        {
+            return REPLACEMENT;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+    {
+        return REPLACEMENT;
     }
-    return 0.0f;
+    index += length;
+    return codepoint;
 }
 
 bool TextUtils::IsValid(const TextRenderComponent& comp) 
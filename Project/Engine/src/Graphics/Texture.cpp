@@ -1,6 +1,7 @@
 #include "pch.h"
 
 #include "Graphics/Texture.h"
+#include "Graphics/GLStateCache.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "Graphics/stb_image.h"
@@ -48,12 +49,8 @@ Texture::Texture(const char* image, const char* texType, GLuint slot, GLenum pix
 	//unit = slot;
 	//glBindTexture(GL_TEXTURE_2D, ID);
 
-	// Only bind to unit if slot is valid
-	if (slot >= 0) 
-	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, ID);
-	}
+	// Upload through unit 0, draw-time binding picks the unit the shader samples from
+	GLStateCache::GetInstance().BindTexture(0, ID);
 
 	// Configures the type of algorithm that is used to make the image smaller or bigger
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
@@ -76,7 +73,7 @@ Texture::Texture(const char* image, const char* texType, GLuint slot, GLenum pix
 	stbi_image_free(bytes);
 
 	// Unbinds the OpenGL Texture object so that it can't accidentally be modified
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::GetInstance().BindTexture(0, 0);
 }
 
 bool Texture::LoadAsset(const std::string& path) {
@@ -117,16 +114,16 @@ void Texture::texUnit(Shader& shader, const char* uniform, GLuint unit)
 
 void Texture::Bind()
 {
-	glActiveTexture(GL_TEXTURE0 + unit);
-	glBindTexture(GL_TEXTURE_2D, ID);
+	GLStateCache::GetInstance().BindTexture(unit, ID);
 }
 
 void Texture::Unbind()
 {
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::GetInstance().BindTexture(unit, 0);
 }
 
 void Texture::Delete()
 {
 	glDeleteTextures(1, &ID);
+	GLStateCache::GetInstance().OnTextureDeleted(ID);
 }
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "pch.h"
+#include "Graphics/TriangleBVH.hpp"
+#include "Graphics/Mesh.h"
+
+void TriangleBVH::Build(const std::vector<Mesh>& meshes)
+{
+	Clear();
+
+	std::vector<Triangle> source;
+	for (uint32_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++)
+	{
+		const Mesh& mesh = meshes[meshIndex];
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+		{
+			glm::vec3 v0 = mesh.vertices[mesh.indices[i]].position;
+			glm::vec3 v1 = mesh.vertices[mesh.indices[i + 1]].position;
+			glm::vec3 v2 = mesh.vertices[mesh.indices[i + 2]].position;
+			source.push_back(Triangle{ v0, v1 - v0, v2 - v0, meshIndex, static_cast<uint32_t>(i / 3) });
+		}
+	}
+
+	if (source.empty())
+	{
+		return;
+	}
+
+	std::vector<AABB> triangleBounds(source.size());
+	std::vector<glm::vec3> centroids(source.size());
+	std::vector<uint32_t> order(source.size());
+	for (uint32_t i = 0; i < source.size(); i++)
+	{
+		const Triangle& triangle = source[i];
+		AABB box;
+		box.Expand(triangle.v0);
+		box.Expand(triangle.v0 + triangle.edge1);
+		box.Expand(triangle.v0 + triangle.edge2);
+		triangleBounds[i] = box;
+		centroids[i] = box.Center();
+		order[i] = i;
+	}
+
+	// A binary tree with at most one triangle per leaf has fewer than 2n nodes
+	nodes.reserve(source.size() * 2);
+	Node rootNode;
+	rootNode.first = 0;
+	rootNode.count = static_cast<uint32_t>(source.size());
+	nodes.push_back(rootNode);
+	Subdivide(0, order, triangleBounds, centroids);
+
+	// Store triangles in leaf order so traversal reads them sequentially
+	triangles.reserve(source.size());
+	for (uint32_t index : order)
+	{
+		triangles.push_back(source[index]);
+	}
+}
+
+void TriangleBVH::Clear()
+{
+	triangles.clear();
+	nodes.clear();
+}
+
+void TriangleBVH::Subdivide(uint32_t nodeIndex, std::vector<uint32_t>& order, const std::vector<AABB>& triangleBounds, const std::vector<glm::vec3>& centroids)
+{
+	const uint32_t first = nodes[nodeIndex].first;
+	const uint32_t count = nodes[nodeIndex].count;
+
+	AABB box;
+	AABB centroidBox;
+	for (uint32_t i = first; i < first + count; i++)
+	{
+		box.Expand(triangleBounds[order[i]]);
+		centroidBox.Expand(centroids[order[i]]);
+	}
+	nodes[nodeIndex].box = box;
+
+	if (count <= MAX_LEAF_TRIANGLES)
+	{
+		return;
+	}
+
+	auto surfaceArea = [](const AABB& b) {
+		if (!b.IsValid()) return 0.0f;
+		glm::vec3 size = b.max - b.min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	};
+
+	// Find the cheapest split plane by binning centroids along each axis
+	int bestAxis = -1;
+	int bestSplit = 0;
+	float bestCost = surfaceArea(box) * static_cast<float>(count);
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float axisMin = centroidBox.min[axis];
+		float axisExtent = centroidBox.max[axis] - axisMin;
+		if (axisExtent <= 0.0f)
+		{
+			continue;
+		}
+
+		AABB binBounds[BIN_COUNT];
+		uint32_t binCounts[BIN_COUNT] = {};
+		float scale = BIN_COUNT / axisExtent;
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			int bin = std::min(BIN_COUNT - 1, static_cast<int>((centroids[order[i]][axis] - axisMin) * scale));
+			binCounts[bin]++;
+			binBounds[bin].Expand(triangleBounds[order[i]]);
+		}
+
+		// Sweep from both ends to get the area and count on each side of every plane
+		float leftArea[BIN_COUNT - 1];
+		uint32_t leftCount[BIN_COUNT - 1];
+		AABB leftBox;
+		uint32_t leftSum = 0;
+		for (int i = 0; i < BIN_COUNT - 1; i++)
+		{
+			leftSum += binCounts[i];
+			leftBox.Expand(binBounds[i]);
+			leftCount[i] = leftSum;
+			leftArea[i] = surfaceArea(leftBox);
+		}
+
+		AABB rightBox;
+		uint32_t rightSum = 0;
+		for (int i = BIN_COUNT - 1; i > 0; i--)
+		{
+			rightSum += binCounts[i];
+			rightBox.Expand(binBounds[i]);
+			float cost = leftArea[i - 1] * static_cast<float>(leftCount[i - 1]) + surfaceArea(rightBox) * static_cast<float>(rightSum);
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = i;
+			}
+		}
+	}
+
+	uint32_t middle;
+	if (bestAxis >= 0)
+	{
+		float axisMin = centroidBox.min[bestAxis];
+		float scale = BIN_COUNT / (centroidBox.max[bestAxis] - axisMin);
+		auto begin = order.begin() + first;
+		auto split = std::partition(begin, begin + count, [&](uint32_t index) {
+			int bin = std::min(BIN_COUNT - 1, static_cast<int>((centroids[index][bestAxis] - axisMin) * scale));
+			return bin < bestSplit;
+		});
+		middle = static_cast<uint32_t>(split - order.begin());
+	}
+	else
+	{
+		// Splitting doesn't pay off, but keep leaves small by halving along the widest axis
+		glm::vec3 extent = centroidBox.max - centroidBox.min;
+		int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		middle = first + count / 2;
+		std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + first + count, [&](uint32_t a, uint32_t b) {
+			return centroids[a][axis] < centroids[b][axis];
+		});
+	}
+
+	if (middle == first || middle == first + count)
+	{
+		middle = first + count / 2;
+	}
+
+	uint32_t leftIndex = static_cast<uint32_t>(nodes.size());
+	nodes.emplace_back();
+	nodes.emplace_back();
+	nodes[leftIndex].first = first;
+	nodes[leftIndex].count = middle - first;
+	nodes[leftIndex + 1].first = middle;
+	nodes[leftIndex + 1].count = first + count - middle;
+
+	nodes[nodeIndex].first = leftIndex;
+	nodes[nodeIndex].count = 0;
+
+	Subdivide(leftIndex, order, triangleBounds, centroids);
+	Subdivide(leftIndex + 1, order, triangleBounds, centroids);
+}
+
+bool TriangleBVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleRayHit& hit) const
+{
+	if (nodes.empty())
+	{
+		return false;
+	}
+
+	const glm::vec3 invDirection = 1.0f / direction;
+	auto boxEntry = [&](const AABB& box, float limit, float& entry) {
+		glm::vec3 t1 = (box.min - origin) * invDirection;
+		glm::vec3 t2 = (box.max - origin) * invDirection;
+		glm::vec3 tMin = glm::min(t1, t2);
+		glm::vec3 tMax = glm::max(t1, t2);
+		float tNear = std::max(std::max(tMin.x, tMin.y), tMin.z);
+		float tFar = std::min(std::min(tMax.x, tMax.y), tMax.z);
+		entry = tNear;
+		return tNear <= tFar && tFar >= 0.0f && tNear <= limit;
+	};
+
+	float closest = maxDistance;
+	bool found = false;
+
+	float rootEntry;
+	if (!boxEntry(nodes[0].box, closest, rootEntry))
+	{
+		return false;
+	}
+
+	// SAH splits can be lopsided, so the depth isn't bounded by log2 of the triangle count
+	std::vector<uint32_t> stack;
+	stack.reserve(64);
+	stack.push_back(0);
+
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				float distance;
+				glm::vec2 barycentric;
+				if (IntersectTriangle(triangles[i], origin, direction, closest, distance, barycentric))
+				{
+					closest = distance;
+					found = true;
+					hit.distance = distance;
+					hit.meshIndex = triangles[i].meshIndex;
+					hit.triangleIndex = triangles[i].triangleIndex;
+					hit.barycentric = barycentric;
+				}
+			}
+			continue;
+		}
+
+		// Push the farther child first so the nearer one is visited next and clips the ray sooner
+		float leftEntry, rightEntry;
+		bool hitLeft = boxEntry(nodes[node.first].box, closest, leftEntry);
+		bool hitRight = boxEntry(nodes[node.first + 1].box, closest, rightEntry);
+
+		if (hitLeft && hitRight)
+		{
+			bool leftFirst = leftEntry <= rightEntry;
+			stack.push_back(leftFirst ? node.first + 1 : node.first);
+			stack.push_back(leftFirst ? node.first : node.first + 1);
+		}
+		else if (hitLeft)
+		{
+			stack.push_back(node.first);
+		}
+		else if (hitRight)
+		{
+			stack.push_back(node.first + 1);
+		}
+	}
+
+	return found;
+}
+
+bool TriangleBVH::IntersectTriangle(const Triangle& triangle, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& distance, glm::vec2& barycentric)
+{
+	// Moller-Trumbore, double sided so picking works from inside and on open meshes
+	constexpr float EPSILON = 1e-8f;
+
+	glm::vec3 p = glm::cross(direction, triangle.edge2);
+	float determinant = glm::dot(triangle.edge1, p);
+	if (std::abs(determinant) < EPSILON)
+	{
+		return false;
+	}
+
+	float invDeterminant = 1.0f / determinant;
+	glm::vec3 s = origin - triangle.v0;
+	float u = glm::dot(s, p) * invDeterminant;
+	if (u < 0.0f || u > 1.0f)
+	{
+		return false;
+	}
+
+	glm::vec3 q = glm::cross(s, triangle.edge1);
+	float v = glm::dot(direction, q) * invDeterminant;
+	if (v < 0.0f || u + v > 1.0f)
+	{
+		return false;
+	}
+
+	float t = glm::dot(triangle.edge2, q) * invDeterminant;
+	if (t < 0.0f || t > maxDistance)
+	{
+		return false;
+	}
+
+	distance = t;
+	barycentric = glm::vec2(u, v);
+	return true;
+}
@@ -0,0 +1,108 @@
+#include "pch.h"
+#include "Graphics/UniformBuffers.hpp"
+#include "Graphics/ClusteredLighting.hpp"
+#include "Graphics/FrameView.hpp"
+#include "Graphics/LightManager.hpp"
+#include "Graphics/RenderStats.hpp"
+
+UniformBuffers& UniformBuffers::GetInstance()
+{
+	static UniformBuffers instance;
+	return instance;
+}
+
+void UniformBuffers::Shutdown()
+{
+	if (cameraUBO != 0)
+	{
+		glDeleteBuffers(1, &cameraUBO);
+		cameraUBO = 0;
+	}
+	if (lightUBO != 0)
+	{
+		glDeleteBuffers(1, &lightUBO);
+		lightUBO = 0;
+	}
+}
+
+void UniformBuffers::EnsureCreated()
+{
+	if (cameraUBO == 0)
+	{
+		glGenBuffers(1, &cameraUBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, UniformBlockBinding::CAMERA, cameraUBO);
+	}
+	if (lightUBO == 0)
+	{
+		glGenBuffers(1, &lightUBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, lightUBO);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, UniformBlockBinding::LIGHTS, lightUBO);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffers::Upload(GLuint buffer, const void* data, GLsizeiptr size)
+{
+	// Respecifying the whole store lets the driver hand back fresh memory instead of
+	// stalling on draws from the previous view that still read the old contents
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	RENDER_STATS_ADD(bufferUploadBytes, size);
+}
+
+void UniformBuffers::UpdateCamera(const FrameView& frameView)
+{
+	EnsureCreated();
+
+	CameraBlock block{};
+	block.view = frameView.view;
+	block.projection = frameView.projection;
+	block.viewProjection = frameView.viewProjection;
+	block.cameraPosition = glm::vec4(frameView.cameraPosition, 1.0f);
+
+	Upload(cameraUBO, &block, sizeof(block));
+}
+
+void UniformBuffers::UpdateLights(const LightSet& lightSet, const FrameView& frameView)
+{
+	EnsureCreated();
+
+	LightBlock block{};
+
+	const DirectionalLight& dirLight = lightSet.directionalLight;
+	block.dirLight.direction = glm::vec4(dirLight.direction, 0.0f);
+	block.dirLight.ambient = glm::vec4(dirLight.ambient, 0.0f);
+	block.dirLight.diffuse = glm::vec4(dirLight.diffuse, 0.0f);
+	block.dirLight.specular = glm::vec4(dirLight.specular, 0.0f);
+
+	// Fragments find their cluster from gl_FragCoord and view depth with the same mapping
+	// ClusteredLighting bins with
+	glm::vec2 sliceScale = ClusteredLighting::GetSliceScale(frameView);
+	block.clusterScale = glm::vec4(
+		static_cast<float>(ClusteredLighting::GRID_X) / frameView.viewportWidth,
+		static_cast<float>(ClusteredLighting::GRID_Y) / frameView.viewportHeight,
+		sliceScale.x, sliceScale.y);
+	block.clusterDims = glm::ivec4(ClusteredLighting::GRID_X, ClusteredLighting::GRID_Y, ClusteredLighting::GRID_Z,
+		static_cast<int>(ClusteredLighting::GetInstance().GetLightCount()));
+
+	Upload(lightUBO, &block, sizeof(block));
+}
+
+void UniformBuffers::BindShaderBlocks(GLuint program)
+{
+	GLuint cameraIndex = glGetUniformBlockIndex(program, "CameraData");
+	if (cameraIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, cameraIndex, UniformBlockBinding::CAMERA);
+	}
+
+	GLuint lightIndex = glGetUniformBlockIndex(program, "LightData");
+	if (lightIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, lightIndex, UniformBlockBinding::LIGHTS);
+	}
+}
@@ -1,6 +1,7 @@
 #include "pch.h"
 
 #include "Graphics/VAO.h"
+#include "Graphics/GLStateCache.hpp"
 
 VAO::VAO()
 {
@@ -22,15 +23,19 @@ void VAO::Bind()
 		// genVertex will crash if glfw isn't init yet, so we will init only when binding
 	}
 
-	glBindVertexArray(ID);
+	GLStateCache::GetInstance().BindVertexArray(ID);
 }
 
 void VAO::Unbind()
 {
-	glBindVertexArray(0);
+	GLStateCache::GetInstance().BindVertexArray(0);
 }
 
 void VAO::Delete()
 {
-	glDeleteVertexArrays(1, &ID);
+	if (ID != 0)
+	{
+		glDeleteVertexArrays(1, &ID);
+		GLStateCache::GetInstance().OnVertexArrayDeleted(ID);
+	}
 }
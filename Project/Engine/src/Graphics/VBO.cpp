@@ -1,6 +1,7 @@
 #include "pch.h"
 
 #include "Graphics/VBO.h"
+#include "Graphics/RenderStats.hpp"
 
 // Constructor for static mesh data
 VBO::VBO(std::vector<Vertex>& vertices)
@@ -11,6 +12,7 @@ VBO::VBO(std::vector<Vertex>& vertices)
 	// Its first argument is the type of the buffer we want to copy data into: the vertex buffer object currently bound to the GL_ARRAY_BUFFER target. 
 	// The second argument specifies the size of the data (in bytes) we want to pass to the buffer; a simple sizeof of the vertex data suffices. 
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+	RENDER_STATS_ADD(bufferUploadBytes, vertices.size() * sizeof(Vertex));
 }
 
 void VBO::Bind()
@@ -41,6 +43,7 @@ void VBO::UpdateData(const void* data, size_t size, size_t offset)
 {
 	Bind();
 	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	RENDER_STATS_ADD(bufferUploadBytes, size);
 }
 
 void VBO::InitializeBuffer(size_t size, GLenum usage)
@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "Graphics/VertexFormat.hpp"
+#include <glm/gtc/packing.hpp>
+
+PositionDecode PositionDecode::FromBounds(const AABB& bounds)
+{
+	PositionDecode decode;
+	if (bounds.IsValid())
+	{
+		decode.offset = bounds.min;
+		decode.scale = bounds.max - bounds.min;
+	}
+	return decode;
+}
+
+glm::vec2 VertexFormat::EncodeOctahedral(const glm::vec3& normal)
+{
+	float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+	if (length <= 0.0f)
+	{
+		return glm::vec2(0.0f);
+	}
+
+	// Project onto the octahedron, then fold the lower hemisphere over the diagonals
+	glm::vec3 n = normal / length;
+	glm::vec2 encoded(n.x, n.y);
+	if (n.z < 0.0f)
+	{
+		glm::vec2 signs(encoded.x >= 0.0f ? 1.0f : -1.0f, encoded.y >= 0.0f ? 1.0f : -1.0f);
+		encoded = (glm::vec2(1.0f) - glm::abs(glm::vec2(encoded.y, encoded.x))) * signs;
+	}
+	return encoded;
+}
+
+glm::vec3 VertexFormat::DecodeOctahedral(const glm::vec2& encoded)
+{
+	// Same as decodeOctahedral in the vertex shaders
+	glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+	float t = std::max(-n.z, 0.0f);
+	n.x += n.x >= 0.0f ? -t : t;
+	n.y += n.y >= 0.0f ? -t : t;
+	return glm::normalize(n);
+}
+
+PackedVertex VertexFormat::Pack(const Vertex& vertex, const PositionDecode& decode)
+{
+	PackedVertex packed{};
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float normalized = decode.scale[axis] > 0.0f ? (vertex.position[axis] - decode.offset[axis]) / decode.scale[axis] : 0.0f;
+		packed.position[axis] = glm::packUnorm1x16(normalized);
+	}
+	packed.position[3] = 0;
+
+	glm::vec2 octahedral = EncodeOctahedral(vertex.normal);
+	packed.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(octahedral.x));
+	packed.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(octahedral.y));
+
+	packed.texUV[0] = glm::packHalf1x16(vertex.texUV.x);
+	packed.texUV[1] = glm::packHalf1x16(vertex.texUV.y);
+
+	return packed;
+}
@@ -129,6 +129,12 @@ void AndroidPlatform::MakeContextCurrent() {
     }
 }
 
+void AndroidPlatform::ReleaseContext() {
+    if (display != EGL_NO_DISPLAY) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+}
+
 void* AndroidPlatform::GetNativeWindow() {
     return static_cast<void*>(window);
 }
@@ -3,6 +3,7 @@
 #ifndef ANDROID
 #include "Platform/DesktopPlatform.h"
 #include "Input/Keys.h"
+#include "WindowManager.hpp"
 #include <glad/glad.h>
 #include <iostream>
 #include <chrono>
@@ -201,6 +202,10 @@ void DesktopPlatform::MakeContextCurrent() {
     }
 }
 
+void DesktopPlatform::ReleaseContext() {
+    glfwMakeContextCurrent(nullptr);
+}
+
 void* DesktopPlatform::GetNativeWindow() {
     return window;
 }
@@ -211,7 +216,8 @@ void DesktopPlatform::ErrorCallback(int error, const char* description) {
 }
 
 void DesktopPlatform::FramebufferSizeCallback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    // Cache the size in WindowManager so per-frame queries don't go back to GLFW
+    WindowManager::fbsize_cb(window, width, height);
 }
 
 void DesktopPlatform::FocusCallback(GLFWwindow* window, int focused) {
@@ -85,8 +85,6 @@ void SceneInstance::Update(double dt) {
 }
 
 void SceneInstance::Draw() {
-	ECSManager& mainECS = ECSRegistry::GetInstance().GetECSManager(scenePath);
-
 	GraphicsManager& gfxManager = GraphicsManager::GetInstance();
 	//RenderSystem::getInstance().BeginFrame();
 	gfxManager.BeginFrame();
@@ -98,14 +96,7 @@ void SceneInstance::Draw() {
 	//RenderSystem::getInstance().Submit(backpackModel, transform, shader);
 
 	gfxManager.SetCamera(&camera);
-	if (mainECS.modelSystem)
-	{
-		mainECS.modelSystem->Update();
-	}
-	if (mainECS.textSystem)
-	{
-		mainECS.textSystem->Update();
-	}
+	ExtractRenderWorld();
 
 	gfxManager.Render();
 
@@ -159,66 +150,62 @@ void SceneInstance::processInput(float deltaTime)
 	camera.ProcessMouseMovement(xoffset, yoffset);
 }
 
-void SceneInstance::DrawLightCubes() 
+void SceneInstance::ExtractRenderWorld()
 {
-	// Get light positions from LightManager instead of renderSystem
-	LightManager& lightManager = LightManager::getInstance();
-	const auto& pointLights = lightManager.getPointLights();
+	RenderWorld* world = GraphicsManager::GetInstance().BeginWorldExtraction();
+	if (!world)
+	{
+		return;
+	}
 
-	// Draw light cubes at point light positions
-	for (size_t i = 0; i < pointLights.size() && i < 4; i++) {
-		lightShader->Activate();
-
-		// Set up matrices for light cube
-		glm::mat4 lightModel = glm::mat4(1.0f);
-		lightModel = glm::translate(lightModel, pointLights[i].position);
-		lightModel = glm::scale(lightModel, glm::vec3(0.2f)); // Make them smaller
-
-		// Set up view and projection matrices
-		glm::mat4 view = camera.GetViewMatrix();
-		glm::mat4 projection = glm::perspective(
-			glm::radians(camera.Zoom),
-			(float)WindowManager::GetWindowWidth() / (float)WindowManager::GetWindowHeight(),
-			0.1f, 100.0f
-		);
-
-		lightShader->setMat4("model", lightModel);
-		lightShader->setMat4("view", view);
-		lightShader->setMat4("projection", projection);
-		//lightShader->setVec3("lightColor", pointLights[i].diffuse); // Use light color
-
-		lightCubeMesh->Draw(*lightShader, camera);
+	ECSManager& mainECS = ECSRegistry::GetInstance().GetECSManager(scenePath);
+	if (mainECS.modelSystem)
+	{
+		mainECS.modelSystem->Extract(*world);
+	}
+	if (mainECS.textSystem)
+	{
+		mainECS.textSystem->Extract(*world);
 	}
 }
 
-void SceneInstance::DrawLightCubes(const Camera& cameraOverride)
+void SceneInstance::DrawLightCubes() 
+{
+	DrawLightCubes(camera);
+}
+
+void SceneInstance::DrawLightCubes(const Camera&)
 {
 	// Get light positions from LightManager instead of renderSystem
 	LightManager& lightManager = LightManager::getInstance();
 	const auto& pointLights = lightManager.getPointLights();
 
-	// Draw light cubes at point light positions
-	for (size_t i = 0; i < pointLights.size() && i < 4; i++) {
-		lightShader->Activate();
-
-		// Set up matrices for light cube
-		glm::mat4 lightModel = glm::mat4(1.0f);
-		lightModel = glm::translate(lightModel, pointLights[i].position);
-		lightModel = glm::scale(lightModel, glm::vec3(0.2f)); // Make them smaller
-
-		// Set up view and projection matrices using the override camera
-		glm::mat4 view = cameraOverride.GetViewMatrix();
-		glm::mat4 projection = glm::perspective(
-			glm::radians(cameraOverride.Zoom),
-			(float)WindowManager::GetWindowWidth() / (float)WindowManager::GetWindowHeight(),
-			0.1f, 100.0f
-		);
-
-		lightShader->setMat4("model", lightModel);
-		lightShader->setMat4("view", view);
-		lightShader->setMat4("projection", projection);
-		//lightShader->setVec3("lightColor", pointLights[i].diffuse); // Use light color
-
-		lightCubeMesh->Draw(*lightShader, cameraOverride);
+	// Every light the clustered path shades gets a cube, not just the old fixed four
+	std::vector<glm::vec3> lightPositions;
+	lightPositions.reserve(pointLights.size());
+	for (const PointLight& pointLight : pointLights) {
+		lightPositions.push_back(pointLight.position);
 	}
+
+	// Drawn after this frame's packets, which may be on the render thread once the scene has moved on
+	std::shared_ptr<Shader> shader = lightShader;
+	std::shared_ptr<Mesh> mesh = lightCubeMesh;
+	GraphicsManager::GetInstance().SubmitRenderCommand([shader, mesh, lightPositions]()
+	{
+		// View and projection come from the CameraData block GraphicsManager::Render filled for this camera
+		shader->Activate();
+
+		// Draw light cubes at point light positions
+		for (const glm::vec3& position : lightPositions) {
+			// Set up matrices for light cube
+			glm::mat4 lightModel = glm::mat4(1.0f);
+			lightModel = glm::translate(lightModel, position);
+			lightModel = glm::scale(lightModel, glm::vec3(0.2f)); // Make them smaller
+
+			shader->setMat4(Uniforms::Model, lightModel);
+			//shader->setVec3("lightColor", pointLights[i].diffuse); // Use light color
+
+			mesh->Draw(*shader);
+		}
+	});
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <ECS/ECSRegistry.hpp>
 #include <Scene/SceneManager.hpp>
 #include <Scene/SceneInstance.hpp>
+#include <Graphics/RenderThread.hpp>
 #include <filesystem>
 
 SceneManager::~SceneManager() {
@@ -20,6 +21,9 @@ void SceneManager::LoadTestScene() {
 // The current scene is exited and cleaned up before loading the new scene.
 // Also sets the new scene as the active ECSManager in the ECSRegistry.
 void SceneManager::LoadScene(const std::string& scenePath) {
+	// The old scene's GL resources may still be drawn by frames in flight
+	RenderThread::ContextScope context;
+
 	// Exit and clean up the current scene if it exists.
 	if (currentScene) {
 		currentScene->Exit();
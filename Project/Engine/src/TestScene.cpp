@@ -123,7 +123,7 @@ void TestScene::Update()
 		glm::mat4 lightModel = glm::mat4(1.0f);
 		lightModel = glm::translate(lightModel, lightPositions[i]);
 		lightShader->setMat4("model", lightModel);
-		lightCubeMesh->Draw(*lightShader, camera);
+		lightCubeMesh->Draw(*lightShader);
 	}
 
 	// Update systems.
@@ -189,7 +189,7 @@ void TestScene::DrawLightCubes(const Camera &cameraOverride)
 	const auto &pointLights = lightManager.getPointLights();
 
 	// Draw light cubes at point light positions
-	for (size_t i = 0; i < pointLights.size() && i < 4; i++)
+	for (size_t i = 0; i < pointLights.size(); i++)
 	{
 		lightShader->Activate();
 
@@ -210,6 +210,6 @@ void TestScene::DrawLightCubes(const Camera &cameraOverride)
 		lightShader->setMat4("projection", projection);
 		// lightShader->setVec3("lightColor", pointLights[i].diffuse); // Use light color
 
-		lightCubeMesh->Draw(*lightShader, cameraOverride);
+		lightCubeMesh->Draw(*lightShader);
 	}
 }
\ No newline at end of file
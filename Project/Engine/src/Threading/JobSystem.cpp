@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "Threading/JobSystem.hpp"
+
+JobSystem& JobSystem::GetInstance()
+{
+	static JobSystem instance;
+	return instance;
+}
+
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+void JobSystem::Initialize(uint32_t workerCount)
+{
+	if (!workers.empty())
+	{
+		return;
+	}
+
+	if (workerCount == 0)
+	{
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	stopping = false;
+	workers.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; i++)
+	{
+		workers.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+
+	std::cout << "[JobSystem] Started " << workerCount << " worker threads" << std::endl;
+}
+
+void JobSystem::Shutdown()
+{
+	if (workers.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t rangeSize, const RangeJob& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	rangeSize = std::max(rangeSize, 1u);
+	const uint32_t rangeCount = GetRangeCount(count, rangeSize);
+
+	if (workers.empty() || rangeCount == 1 || insideJob)
+	{
+		for (uint32_t range = 0; range < rangeCount; range++)
+		{
+			uint32_t begin = range * rangeSize;
+			job(begin, std::min(begin + rangeSize, count), range);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> submitLock(submitMutex);
+	auto loop = std::make_shared<Loop>();
+	loop->job = &job;
+	loop->count = count;
+	loop->rangeSize = rangeSize;
+	loop->rangeCount = rangeCount;
+	loop->pendingRanges.store(rangeCount);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		currentLoop = loop;
+		loopGeneration++;
+	}
+	wakeCondition.notify_all();
+
+	// The caller works too instead of idling until the workers finish
+	RunRanges(*loop);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	doneCondition.wait(lock, [&] { return loop->pendingRanges.load() == 0; });
+	currentLoop.reset();
+}
+
+void JobSystem::WorkerLoop()
+{
+	uint64_t seenGeneration = 0;
+	while (true)
+	{
+		std::shared_ptr<Loop> loop;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeCondition.wait(lock, [&] { return stopping || loopGeneration != seenGeneration; });
+			if (stopping)
+			{
+				return;
+			}
+			seenGeneration = loopGeneration;
+			loop = currentLoop;
+		}
+
+		if (loop)
+		{
+			RunRanges(*loop);
+		}
+	}
+}
+
+void JobSystem::RunRanges(Loop& loop)
+{
+	insideJob = true;
+	while (true)
+	{
+		uint32_t range = loop.nextRange.fetch_add(1);
+		if (range >= loop.rangeCount)
+		{
+			break;
+		}
+
+		uint32_t begin = range * loop.rangeSize;
+		(*loop.job)(begin, std::min(begin + loop.rangeSize, loop.count), range);
+
+		if (loop.pendingRanges.fetch_sub(1) == 1)
+		{
+			// Lock so the notify can't slip in between the caller's check and its wait
+			std::lock_guard<std::mutex> lock(mutex);
+			doneCondition.notify_one();
+		}
+	}
+	insideJob = false;
+}
@@ -7,6 +7,7 @@
 #include "Engine.h"
 #include "ECS/ECSRegistry.hpp"
 #include "Graphics/GraphicsManager.hpp"
+#include "Graphics/RenderThread.hpp"
 
 #define UNREFERENCED_PARAMETER(P) (P)
 
@@ -152,7 +153,15 @@ void WindowManager::fbsize_cb(PlatformWindow ptr_win, int _width, int _height) {
     WindowManager::width = _width;
     WindowManager::height = _height;
 
-    glViewport(0, 0, _width, _height);
+    // The editor overrides these with the scene panel size before each scene render
+    WindowManager::viewportWidth = _width;
+    WindowManager::viewportHeight = _height;
+
+    // Events are polled on the main thread, which doesn't own the context while the render
+    // thread runs. The render thread sets the viewport from each frame's view instead
+    if (!RenderThread::GetInstance().IsRunning()) {
+        glViewport(0, 0, _width, _height);
+    }
 
     // Call GraphicsManager to update UI positions based on new window size
     //GraphicsManager::OnWindowResize(_width, _height);
@@ -247,6 +256,18 @@ void WindowManager::SwapBuffers() {
     }
 }
 
+void WindowManager::MakeContextCurrent() {
+    if (platform) {
+        platform->MakeContextCurrent();
+    }
+}
+
+void WindowManager::ReleaseContext() {
+    if (platform) {
+        platform->ReleaseContext();
+    }
+}
+
 void WindowManager::PollEvents() {
     if (platform) {
         platform->PollEvents();
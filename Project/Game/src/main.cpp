@@ -1,10 +1,17 @@
 #include "Engine.h"
 #include "GameManager.h"
 #include <iostream>
+#include <cstring>
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "=== GAME BUILD ===" << std::endl;
 
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--render-thread") == 0) {
+            Engine::SetThreadedRendering(true);
+        }
+    }
+
     Engine::Initialize();
     GameManager::Initialize();
 
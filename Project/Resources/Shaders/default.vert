@@ -1,25 +1,50 @@
 #version 330 core
+// Packed vertex (see Graphics/VertexFormat.hpp): position quantized to the mesh bounds, octahedral normal
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
+layout (location = 1) in vec2 aNormalOct;
 layout (location = 3) in vec2 aTexCoord;
+#ifdef INSTANCED
+// Per-instance model matrix, occupies locations 4-7
+layout (location = 4) in mat4 aInstanceModel;
+#endif
 
 out vec3 FragPos;
 out vec3 Normal;
-out vec3 color;
 out vec2 TexCoords;
 
+#ifndef INSTANCED
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#endif
+
+// Maps the quantized position back to model space
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+layout (std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+};
+
+vec3 decodeOctahedral(vec2 e)
+{
+   vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+   float t = max(-n.z, 0.0);
+   n.x += n.x >= 0.0 ? -t : t;
+   n.y += n.y >= 0.0 ? -t : t;
+   return normalize(n);
+}
 
 void main()
 {
-   FragPos = vec3(model * vec4(aPos, 1.0));
-   Normal = mat3(transpose(inverse(model))) * aNormal;
+#ifdef INSTANCED
+   mat4 model = aInstanceModel;
+#endif
+   vec3 position = positionOffset + aPos * positionScale;
+   FragPos = vec3(model * vec4(position, 1.0));
+   Normal = mat3(transpose(inverse(model))) * decodeOctahedral(aNormalOct);
    TexCoords = aTexCoord;
 
-   // color = aColor;
-
-   gl_Position = projection * view * vec4(FragPos, 1.0);
+   gl_Position = viewProjection * vec4(FragPos, 1.0);
 }
\ No newline at end of file
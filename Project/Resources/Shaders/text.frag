@@ -1,12 +1,21 @@
 #version 330 core
-in vec2 TexCoords;
+in vec3 TexCoords;
+in vec4 TextColor;
 out vec4 color;
 
-uniform sampler2D text;
-uniform vec3 textColor;
+uniform sampler2DArray text;
+uniform bool distanceField; // Atlas holds signed distances, 0.5 on the outline
 
 void main()
 {    
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = vec4(textColor, 1.0) * sampled;
+    float coverage = texture(text, TexCoords).r;
+    if (distanceField)
+    {
+        // Antialias across about one screen pixel whatever the text is scaled to
+        float width = max(fwidth(coverage) * 0.5, 0.0001);
+        coverage = smoothstep(0.5 - width, 0.5 + width, coverage);
+    }
+
+    vec4 sampled = vec4(1.0, 1.0, 1.0, coverage);
+    color = TextColor * sampled;
 }
\ No newline at end of file
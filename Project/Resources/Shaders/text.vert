@@ -1,12 +1,15 @@
 #version 330 core
-layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
-out vec2 TexCoords;
+layout (location = 0) in vec3 aPos;      // World space (3D) or window pixels (2D)
+layout (location = 1) in vec3 aTexCoord; // Glyph atlas coordinates, z is the atlas page
+layout (location = 2) in vec4 aColor;
+out vec3 TexCoords;
+out vec4 TextColor;
 
 uniform mat4 projection;
-uniform mat4 model;
 
 void main()
 {
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
+    gl_Position = projection * vec4(aPos, 1.0);
+    TexCoords = aTexCoord;
+    TextColor = aColor;
 }
\ No newline at end of file